@@ -1,12 +1,28 @@
 #include <stdio.h>
+#include <string.h>
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
 #include "hardware/adc.h"
 #include "hardware/pwm.h"
 #include "hardware/gpio.h"
 #include "pico/bootrom.h"
+#if LIB_PICO_STDIO_USB
+#include "pico/stdio/driver.h"
+#include "tusb.h"
+#endif
 #include "inc/ssd1306.h"   // Biblioteca para o display SSD1306
 #include "inc/font.h"      // Fontes para caracteres (8x8)
+#include "inc/icones.h"    // Icones 16x16 (sino, cafe, livro)
+#include "inc/latencia.h"  // Medição de latência entrada -> pixel
+#include "inc/tarefas.h"   // Tarefas cooperativas e escalonador
+#include "inc/botoes_pio.h" // Debounce dos botões em PIO
+#include "inc/efeitos_led.h" // Efeitos no LED RGB via PWM + DMA
+#include "inc/repeticao.h"   // Auto-repetição acelerada do joystick
+#include "inc/horario.h"     // Horário HH:MM e passos do editor
+#include "inc/protocolo.h"   // Protocolo binário de configuração via USB
+#include "inc/pomodoro.h"    // Cronograma do pomodoro (máquina de estados)
+#include "inc/diario.h"      // Diário de eventos binário (log adiado)
+#include "telas.h"           // Textos fixos das telas (tools/gera_telas.py)
 
 // ---------------------- DEFINIÇÕES DE HARDWARE ---------------------------
 #define LARGURA_TELA 128
@@ -31,10 +47,13 @@
 
 #define BUZZER 10
 
-static volatile uint32_t tempo_ultimo_botaoA = 0;
-static volatile uint32_t tempo_ultimo_botaoB = 0;
-static volatile uint32_t tempo_ultimo_js     = 0;
-const uint32_t atraso_debounce_us = 200000; // 200 ms
+// Posição dos ícones e da barra de progresso nas telas de contagem
+#define ICONE_X 104
+#define ICONE_Y 4
+#define BARRA_X 14
+#define BARRA_Y 50
+#define BARRA_LARGURA 100
+#define BARRA_ALTURA 6
 
 volatile bool flag_botaoA = false;
 volatile bool flag_botaoB = false;
@@ -46,17 +65,14 @@ static int pos_indicador_anterior = -1;
 ssd1306_t display;
 
 // ---------------------- ESTRUTURAS E TIPOS ---------------------------
-typedef struct {
-    int horas;
-    int minutos;
-} Horario;
-
 typedef enum {
     ESTADO_BEM_VINDO,
     ESTADO_MENU_PRINCIPAL,
     ESTADO_EDITAR_HORA_ATUAL,
     ESTADO_EDITAR_ALARME,
-    ESTADO_MENU_POMODORO
+    ESTADO_MENU_POMODORO,
+    ESTADO_CONTAGEM_ALARME,
+    ESTADO_POMODORO
 } EstadoAplicacao;
 
 typedef enum {
@@ -69,28 +85,81 @@ typedef enum {
 
 // ---------------------- VARIÁVEIS GLOBAIS ---------------------------
 EstadoAplicacao estado_atual = ESTADO_BEM_VINDO;
-Horario horario_atual = {0, 0};
 Horario horario_alarme = {0, 0};
 
 int selecao_menu_principal = 0;
 int selecao_pomodoro = 0;
-const char* opcoes_pomodoro[] = {"25/5", "30/15", "40/20", "60/30"};
+
+#define PRESETS_MAX 4
+
+// Mesma ordem das opções desenhadas no menu:
+// estudo/pausa, ciclos por bloco e pausa longa no fim de cada bloco
+const cronograma_t presets_padrao[PRESETS_MAX] = {
+    {25, 5, 4, 20, 0, false},
+    {30, 15, 4, 30, 0, false},
+    {40, 20, 4, 40, 0, false},
+    {60, 30, 2, 60, 0, false},
+};
+
+// Presets em uso, copiados de presets_padrao no boot; o protocolo USB pode
+// trocá-los e o menu os redesenha.
+cronograma_t presets_pomodoro[PRESETS_MAX];
+int num_presets = PRESETS_MAX;
+
+void restaura_presets() {
+    memcpy(presets_pomodoro, presets_padrao, sizeof(presets_padrao));
+    num_presets = PRESETS_MAX;
+}
+
+// Estado compartilhado entre as tarefas (só a ISR roda fora delas)
+volatile DirecaoJoystick direcao_joystick = JOY_NENHUM;
+int8_t deflexao_x = 0, deflexao_y = 0;   // % do curso, -100..100 (+ = direita/cima)
+bool display_sujo = false;
+bool buzzer_alarme = false;
+bool buzzer_pomodoro = false;
+
+// Lista de alarmes (cada um toca uma vez); o mais próximo fica armado
+#define ALARMES_MAX 8
+Horario alarmes[ALARMES_MAX];
+int num_alarmes = 0;
+int alarme_indice = 0;        // entrada de `alarmes` armada
+uint32_t alarme_versao = 0;   // muda a cada rearme (acorda tarefa_alarme)
+
+bool alarme_armado = false;
+bool alarme_tocando = false;
+uint64_t alarme_prazo_us = 0;
+int alarme_total_s = 0;
+
+bool pomodoro_ativo = false;
+cronograma_t cronograma_ativo;
+pomodoro_t pomodoro;
+uint64_t aviso_fim_us = TAREFA_SEM_PRAZO;   // fim do bipe de troca de fase
+
+// Redesenha a tela em primeiro plano (usado quando o alarme libera a tela)
+void (*desenha_tela_atual)(void) = NULL;
 
 // ---------------------- FUNÇÕES DE INTERUPÇÃO ---------------------------
+// Recebe eventos já sem oscilação (PIO) ou do replay de latência; só o
+// aperto (borda de descida) gera ação.
 void trata_interrupcao_gpio(uint gpio, uint32_t eventos) {
-    uint32_t agora = time_us_32();
-    if (gpio == BOTAO_A && (agora - tempo_ultimo_botaoA > atraso_debounce_us)) {
-         flag_botaoA = true;
-         tempo_ultimo_botaoA = agora;
-    }
-    if (gpio == BOTAO_B && (agora - tempo_ultimo_botaoB > atraso_debounce_us)) {
-         flag_botaoB = true;
-         tempo_ultimo_botaoB = agora;
-    }
-    if (gpio == BOTAO_JOYSTICK && (agora - tempo_ultimo_js > atraso_debounce_us)) {
-         flag_botaoJS = true;
-         tempo_ultimo_js = agora;
-    }
+    if (!(eventos & GPIO_IRQ_EDGE_FALL)) return;
+    if (!latencia_botao(gpio)) return;
+    if (gpio == BOTAO_A) flag_botaoA = true;
+    if (gpio == BOTAO_B) flag_botaoB = true;
+    if (gpio == BOTAO_JOYSTICK) flag_botaoJS = true;
+    tarefas_sinaliza();
+}
+
+void trata_evento_botao(uint gpio, bool pressionado, uint32_t tick) {
+    diario_registra(pressionado ? EV_BOTAO_APERTA : EV_BOTAO_SOLTA, gpio, tick);
+    trata_interrupcao_gpio(gpio, pressionado ? GPIO_IRQ_EDGE_FALL : GPIO_IRQ_EDGE_RISE);
+}
+
+// Envia o quadro ao display e registra quando os pixels chegaram ao barramento
+void envia_display() {
+    uint32_t inicio = time_us_32();
+    ssd1306_send_data(&display);
+    latencia_quadro(inicio, time_us_32());
 }
 
 // ---------------------- FUNÇÃO DE VERIFICAÇÃO DO BOOTSEL ---------------------------
@@ -98,35 +167,67 @@ void verifica_bootsel() {
     if (flag_botaoJS) {
         flag_botaoJS = false;
         ssd1306_fill(&display, false);
-        ssd1306_send_data(&display);
+        envia_display();
         reset_usb_boot(0, 0);
     }
 }
 
 // ---------------------- FUNÇÃO AUXILIAR: PREENCHE UM RETÂNGULO ---------------------------
 void ssd1306_fill_rect(ssd1306_t *disp, int x, int y, int w, int h, bool color) {
-    for (int i = y; i < y + h; i++) {
-        for (int j = x; j < x + w; j++) {
-            ssd1306_pixel(disp, j, i, color);
-        }
-    }
+    ssd1306_fill_area(disp, x, y, w, h, color ? SSD1306_OP_SET : SSD1306_OP_CLEAR);
+}
+
+// Desenha a barra de progresso (sem enviar ao display)
+void desenha_barra_progresso(int decorrido, int total) {
+    int interno = BARRA_LARGURA - 2;
+    int preenchido = (total > 0) ? (interno * decorrido) / total : interno;
+    ssd1306_rect(&display, BARRA_Y, BARRA_X, BARRA_LARGURA, BARRA_ALTURA, true, false);
+    ssd1306_fill_area(&display, BARRA_X + 1, BARRA_Y + 1, preenchido, BARRA_ALTURA - 2, SSD1306_OP_SET);
+    ssd1306_fill_area(&display, BARRA_X + 1 + preenchido, BARRA_Y + 1, interno - preenchido, BARRA_ALTURA - 2, SSD1306_OP_CLEAR);
+}
+
+void desenha_icone(const uint8_t *icone) {
+    ssd1306_blit(&display, icone, NULL, ICONE_LARGURA, ICONE_ALTURA, ICONE_X, ICONE_Y, SSD1306_OP_COPY);
+}
+
+// Pede à tarefa do display que envie o quadro na próxima rodada
+void atualiza_display() {
+    display_sujo = true;
+    tarefas_sinaliza();
 }
 
 // Atualiza somente a área onde um texto é exibido
 void atualiza_area_texto(const char* texto, int x, int y, int w, int h) {
     ssd1306_fill_rect(&display, x, y, w, h, false);
     ssd1306_draw_string(&display, texto, x, y);
-    ssd1306_send_data(&display);
+    atualiza_display();
+}
+
+// Enquanto o alarme toca ele é dono da tela e do botão A; as demais telas
+// só guardam qual função as redesenha.
+bool tela_livre() {
+    return !alarme_tocando;
+}
+
+void entra_tela(void (*desenha)(void)) {
+    desenha_tela_atual = desenha;
+    if (tela_livre()) desenha();
+}
+
+bool botao_pendente(volatile bool *flag) {
+    return *flag && !alarme_tocando;
+}
+
+bool consome_botao(volatile bool *flag) {
+    if (!botao_pendente(flag)) return false;
+    *flag = false;
+    latencia_atende_entrada();
+    return true;
 }
 
 // ---------------------- CONFIGURAÇÃO DOS COMPONENTES ---------------------------
 void configura_componentes() {
-    gpio_init(LED_VERMELHO);
-    gpio_set_dir(LED_VERMELHO, GPIO_OUT);
-    gpio_init(LED_VERDE);
-    gpio_set_dir(LED_VERDE, GPIO_OUT);
-    gpio_init(LED_AZUL);
-    gpio_set_dir(LED_AZUL, GPIO_OUT);
+    efeitos_led_inicia(LED_VERMELHO, LED_VERDE, LED_AZUL);
 
     gpio_init(BOTAO_A);
     gpio_set_dir(BOTAO_A, GPIO_IN);
@@ -140,9 +241,8 @@ void configura_componentes() {
     gpio_set_dir(BOTAO_JOYSTICK, GPIO_IN);
     gpio_pull_up(BOTAO_JOYSTICK);
 
-    gpio_set_irq_enabled_with_callback(BOTAO_A, GPIO_IRQ_EDGE_FALL, true, trata_interrupcao_gpio);
-    gpio_set_irq_enabled(BOTAO_B, GPIO_IRQ_EDGE_FALL, true);
-    gpio_set_irq_enabled(BOTAO_JOYSTICK, GPIO_IRQ_EDGE_FALL, true);
+    static const uint pinos_botoes[] = {BOTAO_A, BOTAO_B, BOTAO_JOYSTICK};
+    botoes_pio_inicia(pio0, pinos_botoes, count_of(pinos_botoes), trata_evento_botao);
 
     adc_init();
     adc_gpio_init(JOYSTICK_X_ADC);
@@ -153,89 +253,118 @@ void configura_componentes() {
     gpio_put(BUZZER, 0);
 }
 
-void configura_pwm_no_pino(uint pino) {
-    gpio_set_function(pino, GPIO_FUNC_PWM);
-    uint slice = pwm_gpio_to_slice_num(pino);
-    pwm_set_wrap(slice, 1000);
-    pwm_set_chan_level(slice, pwm_gpio_to_channel(pino), 0);
-    pwm_set_enabled(slice, true);
-}
+// Ações de cada fase do pomodoro: efeito no LED, som e tela. Estudo e pausas
+// respiram na cor da fase; as esperas por confirmação alternam entre a cor
+// da fase e o vermelho e tocam até o A. TOM_AVISO é um bipe curto quando a
+// fase começa sozinha (fim de contagem ou avanço automático).
+typedef enum {
+    TOM_NENHUM,
+    TOM_AVISO,
+    TOM_CONTINUO
+} TomFase;
+
+#define AVISO_US 1000000
 
-void define_brilho_led(uint pino, float brilho) {
-    uint slice = pwm_gpio_to_slice_num(pino);
-    uint canal = pwm_gpio_to_channel(pino);
-    uint nivel = (uint)(brilho * 1000);
-    pwm_set_chan_level(slice, canal, nivel);
-    // Garante que o canal esteja habilitado
-    pwm_set_enabled(slice, true);
+typedef struct {
+    efeito_led_t led;
+    TomFase tom;
+    const char *titulo;
+    const uint8_t *icone;
+} AcoesFase;
+
+static const AcoesFase acoes_fase[NUM_FASES] = {
+    [FASE_ESTUDO]         = {{EFEITO_RESPIRA,   {0, 255, 0},   {0, 255, 0},   0}, TOM_AVISO,    "Estudos",     icone_livro},
+    [FASE_AGUARDA_PAUSA]  = {{EFEITO_TRANSICAO, {0, 255, 0},   {255, 0, 0},   0}, TOM_CONTINUO, "Pausa",       icone_cafe},
+    [FASE_PAUSA]          = {{EFEITO_RESPIRA,   {0, 0, 255},   {0, 0, 255},   0}, TOM_AVISO,    "Pausa",       icone_cafe},
+    [FASE_AGUARDA_ESTUDO] = {{EFEITO_TRANSICAO, {0, 0, 255},   {255, 0, 0},   0}, TOM_CONTINUO, "Estudos",     icone_livro},
+    [FASE_PAUSA_LONGA]    = {{EFEITO_RESPIRA,   {0, 160, 255}, {0, 160, 255}, 0}, TOM_AVISO,    "Pausa longa", icone_cafe},
+    [FASE_CONCLUIDO]      = {{EFEITO_PISCA,     {0, 255, 0},   {0, 255, 0},   2}, TOM_AVISO,    "Concluido",   icone_livro},
+};
+
+// Recoloca o efeito do estado atual; o alarme tocando tem prioridade
+void restaura_leds() {
+    if (alarme_tocando) {
+        efeitos_led_pisca(COR_VERMELHA, 3);
+    } else if (pomodoro_ativo) {
+        efeitos_led_aplica(&acoes_fase[pomodoro.fase].led);
+    } else {
+        efeitos_led_apaga();
+    }
 }
 
-void play_buzzer_tone() {
-    gpio_init(BUZZER);
-    gpio_set_dir(BUZZER, GPIO_OUT);
+// O buzzer divide o slice 5 com o LED verde (GPIO 11), e o slice é do módulo
+// de efeitos: o nível vai para a tabela do DMA, que reescreve o CC inteiro a
+// cada período. Tom = frequência do PWM dos LEDs (~500 Hz).
+#define BUZZER_NIVEL_SOM (EFEITOS_NIVEL_MAX / 2)
+
+void start_buzzer_tone() {
     gpio_set_function(BUZZER, GPIO_FUNC_PWM);
-    
-    uint slice = pwm_gpio_to_slice_num(BUZZER);
-    pwm_set_wrap(slice, 1000); 
-    pwm_set_chan_level(slice, pwm_gpio_to_channel(BUZZER), 1000); 
-    pwm_set_enabled(slice, true);
-    pwm_set_chan_level(slice, pwm_gpio_to_channel(BUZZER), 2000); 
-    sleep_ms(500); // Som por 500 ms
-    pwm_set_chan_level(slice, pwm_gpio_to_channel(BUZZER), 0); 
-    sleep_ms(500); // Silêncio por 500 ms
+}
+
+void set_buzzer_level(uint nivel) {
+    efeitos_led_canal_fixo(BUZZER, (uint16_t)nivel);
 }
 
 void stop_buzzer_tone() {
-    uint slice = pwm_gpio_to_slice_num(BUZZER);
-    pwm_set_enabled(slice, false);
+    efeitos_led_canal_fixo(BUZZER, 0);
     gpio_put(BUZZER, 0);
     gpio_set_function(BUZZER, GPIO_FUNC_SIO);
 }
 
 // ---------------------- FUNÇÕES DE LEITURA DO JOYSTICK ---------------------------
+int8_t deflexao_percentual(uint16_t valor) {
+    int deflexao = ((int)valor - 2048) * 100 / 2048;
+    if (deflexao > 100) deflexao = 100;
+    if (deflexao < -100) deflexao = -100;
+    return (int8_t)deflexao;
+}
+
 DirecaoJoystick le_joystick() {
     const int limiar = 1000;
     adc_select_input(0);
     uint16_t valor_x = adc_read();
     adc_select_input(1);
     uint16_t valor_y = adc_read();
+    latencia_reproduz_joystick(&valor_x, &valor_y);
+    deflexao_x = deflexao_percentual(valor_x);
+    deflexao_y = deflexao_percentual(valor_y);
 
-    if (valor_y > 2048 + limiar) return JOY_CIMA;
-    if (valor_y < 2048 - limiar) return JOY_BAIXO;
-    if (valor_x > 2048 + limiar) return JOY_DIREITA;
-    if (valor_x < 2048 - limiar) return JOY_ESQUERDA;
-    return JOY_NENHUM;
+    DirecaoJoystick direcao = JOY_NENHUM;
+    if (valor_y > 2048 + limiar) direcao = JOY_CIMA;
+    else if (valor_y < 2048 - limiar) direcao = JOY_BAIXO;
+    else if (valor_x > 2048 + limiar) direcao = JOY_DIREITA;
+    else if (valor_x < 2048 - limiar) direcao = JOY_ESQUERDA;
+    latencia_joystick(valor_x, valor_y, direcao);
+    return direcao;
 }
 
 // ---------------------- FUNÇÕES DE EXIBIÇÃO NO DISPLAY ---------------------------
+// Mesma borda de ssd1306_rect, mas em quatro faixas byte a byte
 void desenha_moldura() {
-    ssd1306_rect(&display, 0, 0, LARGURA_TELA, ALTURA_TELA, true, false);
+    ssd1306_fill_area(&display, 0, 0, LARGURA_TELA, 1, SSD1306_OP_SET);
+    ssd1306_fill_area(&display, 0, ALTURA_TELA - 1, LARGURA_TELA, 1, SSD1306_OP_SET);
+    ssd1306_fill_area(&display, 0, 0, 1, ALTURA_TELA, SSD1306_OP_SET);
+    ssd1306_fill_area(&display, LARGURA_TELA - 1, 0, 1, ALTURA_TELA, SSD1306_OP_SET);
 }
 
 void mostra_tela(const char* titulo) {
     ssd1306_fill(&display, false);
     desenha_moldura();
     ssd1306_draw_string(&display, titulo, 10, 5);
-    ssd1306_send_data(&display);
+    atualiza_display();
 }
 
 // ---------------------- MENUS ---------------------------
-void mostrar_boas_vindas() {
-    mostra_tela("Bem vindo ao");
-    ssd1306_draw_string(&display, "Study Buddy", 10, 20);
-    ssd1306_draw_string(&display, "clique A para", 10, 40);
-    ssd1306_draw_string(&display, "continuar", 10, 50);
-    ssd1306_send_data(&display);
-}
-
-void desenha_menu_principal() {
+// Só compõe no buffer: no boot main() a envia direto, antes do escalonador
+void compoe_boas_vindas() {
     ssd1306_fill(&display, false);
     desenha_moldura();
-    ssd1306_draw_string(&display, "Alarme", 22, 10);
-    ssd1306_draw_string(&display, "de estudos", 22, 20);
-    ssd1306_draw_string(&display, "Metodo", 22, 40);
-    ssd1306_draw_string(&display, "pomodoro", 20, 50);
-    ssd1306_send_data(&display);
+    ssd1306_draw_compressed(&display, tela_boas_vindas);
+}
+
+void mostrar_boas_vindas() {
+    compoe_boas_vindas();
+    atualiza_display();
 }
 
 void desenha_seta_menu_principal(int selecao) {
@@ -245,348 +374,804 @@ void desenha_seta_menu_principal(int selecao) {
     }
     ssd1306_draw_string(&display, ":", 10, pos_nova);
     pos_indicador_anterior = pos_nova;
-    ssd1306_send_data(&display);
+    atualiza_display();
 }
 
-void desenha_menu_pomodoro() {
+void desenha_menu_principal() {
     ssd1306_fill(&display, false);
     desenha_moldura();
-    ssd1306_draw_string(&display, "Metodo pomodoro", 6, 5);
-    for (int i = 0; i < 4; i++) {
-         ssd1306_draw_string(&display, opcoes_pomodoro[i], 20, 20 + i * 10);
+    ssd1306_draw_compressed(&display, tela_menu_principal);
+    if (alarme_armado) {
+        ssd1306_blit(&display, icone_sino, NULL, ICONE_LARGURA, ICONE_ALTURA, 108, 2, SSD1306_OP_COPY);
     }
-    ssd1306_send_data(&display);
+    pos_indicador_anterior = -1;
+    desenha_seta_menu_principal(selecao_menu_principal);
 }
 
 void desenha_seta_menu_pomodoro(int selecao) {
     ssd1306_fill_rect(&display, 10, 20, 10, 40, false);
     ssd1306_draw_string(&display, ":", 10, 20 + selecao * 10);
-    ssd1306_send_data(&display);
+    atualiza_display();
 }
 
-Horario editar_horario(const char* titulo, bool ignore) {
-    Horario horario = {0, 0};
-    int indice_edicao = 0;
-    edicao_cancelada = false;
-    bool editando = true;
-    int offsets[4] = {0, 8, 24, 32};
+// As opções saem dos presets em uso (padrão ou enviados pela USB)
+void desenha_menu_pomodoro() {
+    char opcao[12];
+    ssd1306_fill(&display, false);
+    desenha_moldura();
+    ssd1306_draw_compressed(&display, tela_menu_pomodoro);
+    for (int i = 0; i < num_presets; i++) {
+        sprintf(opcao, "%d/%d", presets_pomodoro[i].estudo_min, presets_pomodoro[i].pausa_min);
+        ssd1306_draw_string(&display, opcao, 20, 20 + i * 10);
+    }
+    desenha_seta_menu_pomodoro(selecao_pomodoro);
+}
+
+// ---------------------- EDIÇÃO DE HORÁRIO ---------------------------
+static const char *titulo_edicao = "";
+static Horario horario_editado = {0, 0};
+static int alvo_edicao = 0;
+
+static repeticao_t repeticao_valor;
+
+void desenha_valor_edicao() {
+    static const int offsets[4] = {0, 8, 24, 32};
     int pos_x = (LARGURA_TELA - 40) / 2;  // largura de "HH:MM" = 40px
     int pos_y = 30;
+    char str_horario[6];
+    sprintf(str_horario, "%02d:%02d", horario_editado.horas, horario_editado.minutos);
+    atualiza_area_texto(str_horario, pos_x, pos_y, 40, 16);
+    ssd1306_fill_rect(&display, pos_x, pos_y+16, 40, 8, false);
+    if (alvo_edicao < ALVO_DIGITO) {
+        ssd1306_draw_string(&display, "::", pos_x + offsets[alvo_edicao * 2], pos_y+16);
+    } else {
+        ssd1306_draw_string(&display, ":", pos_x + offsets[alvo_edicao - ALVO_DIGITO], pos_y+16);
+    }
+    atualiza_display();
+}
 
+void desenha_edicao() {
     ssd1306_fill(&display, false);
     desenha_moldura();
-    ssd1306_draw_string(&display, titulo, 10, 5);
-    ssd1306_send_data(&display);
+    ssd1306_draw_string(&display, titulo_edicao, 10, 5);
+    desenha_valor_edicao();
+}
 
-    while(editando) {
-        verifica_bootsel();
-        char str_horario[6];
-        sprintf(str_horario, "%02d:%02d", horario.horas, horario.minutos);
-        atualiza_area_texto(str_horario, pos_x, pos_y, 40, 16);
-        ssd1306_fill_rect(&display, pos_x, pos_y+16, 40, 8, false);
-        ssd1306_draw_string(&display, ":", pos_x + offsets[indice_edicao], pos_y+16);
-        ssd1306_send_data(&display);
-    
-        DirecaoJoystick direcao = le_joystick();
-        if (direcao == JOY_CIMA) {
-            indice_edicao = (indice_edicao + 3) % 4;
-            sleep_ms(200);
-        } else if (direcao == JOY_BAIXO) {
-            indice_edicao = (indice_edicao + 1) % 4;
-            sleep_ms(200);
-        } else if (direcao == JOY_ESQUERDA) { 
-            if (indice_edicao == 0) {
-                int dezena = horario.horas / 10;
-                dezena = (dezena - 1);
-                if (dezena < 0) dezena = 2;
-                int unidade = horario.horas % 10;
-                if (dezena == 2 && unidade > 3) unidade = 3;
-                horario.horas = dezena * 10 + unidade;
-            } else if (indice_edicao == 1) {
-                int dezena = horario.horas / 10;
-                int unidade = horario.horas % 10;
-                int max = (dezena == 2) ? 3 : 9;
-                unidade = (unidade - 1);
-                if (unidade < 0) unidade = max;
-                horario.horas = dezena * 10 + unidade;
-            } else if (indice_edicao == 2) {
-                int dezena = horario.minutos / 10;
-                dezena = (dezena - 1);
-                if (dezena < 0) dezena = 5;
-                int unidade = horario.minutos % 10;
-                horario.minutos = dezena * 10 + unidade;
-            } else if (indice_edicao == 3) {
-                int dezena = horario.minutos / 10;
-                int unidade = horario.minutos % 10;
-                unidade = (unidade - 1);
-                if (unidade < 0) unidade = 9;
-                horario.minutos = dezena * 10 + unidade;
-            }
-            sleep_ms(200);
-        } else if (direcao == JOY_DIREITA) { 
-            if (indice_edicao == 0) {
-                int dezena = horario.horas / 10;
-                dezena = (dezena + 1) % 3;
-                int unidade = horario.horas % 10;
-                if (dezena == 2 && unidade > 3) unidade = 3;
-                horario.horas = dezena * 10 + unidade;
-            } else if (indice_edicao == 1) {
-                int dezena = horario.horas / 10;
-                int unidade = horario.horas % 10;
-                int max = (dezena == 2) ? 3 : 9;
-                unidade = (unidade + 1) % (max + 1);
-                horario.horas = dezena * 10 + unidade;
-            } else if (indice_edicao == 2) {
-                int dezena = horario.minutos / 10;
-                dezena = (dezena + 1) % 6;
-                int unidade = horario.minutos % 10;
-                horario.minutos = dezena * 10 + unidade;
-            } else if (indice_edicao == 3) {
-                int dezena = horario.minutos / 10;
-                int unidade = horario.minutos % 10;
-                unidade = (unidade + 1) % 10;
-                horario.minutos = dezena * 10 + unidade;
-            }
-            sleep_ms(200);
+// Subtarefa: edita HH:MM em horario_editado; B cancela (edicao_cancelada).
+// Cima/baixo movem o cursor (um alvo por inclinação); esquerda/direita
+// alteram o alvo com auto-repetição acelerada.
+tarefa_estado_t editar_horario(tarefa_t *t, const char* titulo) {
+    static int vertical_anterior;
+    TAREFA_INICIO(t);
+    titulo_edicao = titulo;
+    horario_editado = (Horario){0, 0};
+    alvo_edicao = ALVO_HORAS;
+    edicao_cancelada = false;
+    entra_tela(desenha_edicao);
+
+    while (true) {
+        if (direcao_joystick == JOY_NENHUM) {
+            vertical_anterior = 0;
+            repeticao_solta(&repeticao_valor);
+        }
+        TAREFA_ESPERA_ATE(t, direcao_joystick != JOY_NENHUM ||
+                             botao_pendente(&flag_botaoA) || botao_pendente(&flag_botaoB));
+        if (consome_botao(&flag_botaoA)) break;
+        if (consome_botao(&flag_botaoB)) {
+            edicao_cancelada = true;
+            break;
         }
-        
-        if ( flag_botaoA) { 
-            flag_botaoA = false; 
-            editando = false; 
+
+        bool mudou = false;
+        int vertical = (direcao_joystick == JOY_CIMA) ? -1 : (direcao_joystick == JOY_BAIXO) ? 1 : 0;
+        if (vertical != 0 && vertical != vertical_anterior) {
+            alvo_edicao = move_alvo(alvo_edicao, vertical);
+            mudou = true;
+        }
+        vertical_anterior = vertical;
+
+        bool horizontal = (direcao_joystick == JOY_ESQUERDA || direcao_joystick == JOY_DIREITA);
+        int passos = repeticao_atualiza(&repeticao_valor, &repeticao_edicao, horizontal ? deflexao_x : 0,
+                                        to_ms_since_boot(get_absolute_time()));
+        if (passos != 0) {
+            ajusta_alvo(&horario_editado, alvo_edicao, passos);
+            mudou = true;
         }
-        if (flag_botaoB) { 
-            flag_botaoB = false; 
-            edicao_cancelada = true; 
-            editando = false; 
+
+        if (mudou) {
+            latencia_atende_entrada();
+            if (tela_livre()) desenha_valor_edicao();
         }
+        TAREFA_DORME_MS(t, 20);   // cadência da amostragem do joystick
     }
-    return horario; 
+    TAREFA_FIM(t);
+}
+
+// ---------------------- RELÓGIO ---------------------------
+// Horário de parede: segundos do dia no acerto + tempo decorrido desde então
+#define SEGUNDOS_DIA (24 * 60 * 60)
+
+static uint32_t relogio_base_s = 0;
+static uint64_t relogio_base_us = 0;
+
+uint32_t segundos_do_dia() {
+    return (uint32_t)((relogio_base_s + (time_us_64() - relogio_base_us) / 1000000) % SEGUNDOS_DIA);
 }
-  
-void executar_alarme(Horario atual, Horario alarme) {
-    int minutos_atual = atual.horas * 60 + atual.minutos;
-    int minutos_alarme = alarme.horas * 60 + alarme.minutos;
-    if (minutos_alarme <= minutos_atual)
-         minutos_alarme += 24 * 60;
-    int diff_minutos = minutos_alarme - minutos_atual;
-    int segundos_totais = diff_minutos * 60;
+
+void acerta_relogio(int horas, int minutos, int segundos) {
+    relogio_base_s = (uint32_t)(horas * 3600 + minutos * 60 + segundos);
+    relogio_base_us = time_us_64();
+}
+
+// ---------------------- ALARME ---------------------------
+// Arma o alarme da lista que toca primeiro a partir de agora
+void arma_proximo_alarme() {
+    alarme_versao++;
+    alarme_armado = false;
+    uint32_t agora_s = segundos_do_dia();
+    for (int i = 0; i < num_alarmes; i++) {
+        uint32_t alvo_s = (uint32_t)(alarmes[i].horas * 3600 + alarmes[i].minutos * 60);
+        uint32_t falta_s = (alvo_s + SEGUNDOS_DIA - agora_s) % SEGUNDOS_DIA;
+        if (falta_s == 0) falta_s = SEGUNDOS_DIA;
+        if (!alarme_armado || (int)falta_s < alarme_total_s) {
+            alarme_indice = i;
+            alarme_total_s = (int)falta_s;
+            alarme_armado = true;
+        }
+    }
+    if (alarme_armado) {
+        alarme_prazo_us = time_us_64() + (uint64_t)alarme_total_s * 1000000;
+        diario_registra(EV_ALARME_ARMADO, alarmes[alarme_indice].horas * 100 + alarmes[alarme_indice].minutos,
+                        (uint32_t)alarme_total_s);
+    }
+    tarefas_sinaliza();
+}
+
+// Substitui a lista de alarmes (n = 0 cancela todos); usado só pela USB
+void define_alarmes(const Horario *lista, int n) {
+    num_alarmes = 0;
+    for (int i = 0; i < n && i < ALARMES_MAX; i++) {
+        alarmes[num_alarmes++] = lista[i];
+    }
+    arma_proximo_alarme();
+}
+
+void remove_alarme(int indice) {
+    for (int i = indice; i < num_alarmes - 1; i++) alarmes[i] = alarmes[i + 1];
+    num_alarmes--;
+}
+
+// Alarme do editor: entra na lista sem mexer nos outros (os da USB ficam).
+// Horário repetido não duplica; com a lista cheia sai o mais antigo.
+void adiciona_alarme(Horario horario) {
+    for (int i = 0; i < num_alarmes; i++) {
+        if (alarmes[i].horas == horario.horas && alarmes[i].minutos == horario.minutos) {
+            arma_proximo_alarme();
+            return;
+        }
+    }
+    if (num_alarmes == ALARMES_MAX) remove_alarme(0);
+    alarmes[num_alarmes++] = horario;
+    arma_proximo_alarme();
+}
+
+// B na contagem: cancela só o alarme mostrado e arma o próximo da lista
+void cancela_alarme_armado() {
+    if (!alarme_armado) return;
+    remove_alarme(alarme_indice);
+    arma_proximo_alarme();
+}
+
+// Segundos restantes até `fim_us`, arredondados para cima
+int segundos_ate(uint64_t fim_us) {
+    uint64_t agora = time_us_64();
+    if (agora >= fim_us) return 0;
+    return (int)((fim_us - agora + 999999) / 1000000);
+}
+
+// Instante em que o contador de `fim_us` muda de valor
+uint64_t proximo_segundo(uint64_t fim_us) {
+    int restantes = segundos_ate(fim_us);
+    if (restantes <= 0) return fim_us;
+    return fim_us - (uint64_t)(restantes - 1) * 1000000;
+}
+
+void desenha_contagem_alarme() {
     int area_x = (LARGURA_TELA - 40) / 2;
     int area_y = 30, area_w = 40, area_h = 16;
-    
-    while(segundos_totais > 0) {
-         verifica_bootsel();
-         int horas_restantes = segundos_totais / 3600;
-         int minutos_restantes = (segundos_totais % 3600) / 60;
-         int segundos_restantes = segundos_totais % 60;
-         char buffer[10];
-         sprintf(buffer, "%02d:%02d:%02d", horas_restantes, minutos_restantes, segundos_restantes);
-         atualiza_area_texto(buffer, area_x, area_y, area_w, area_h);
-         sleep_ms(1000);
-         segundos_totais--;
-         if(flag_botaoB) {
-             flag_botaoB = false; 
-             return; 
-         }
-    }
-    
-    define_brilho_led(LED_VERMELHO, 1.0);
+    int segundos_totais = segundos_ate(alarme_prazo_us);
+    int horas_restantes = segundos_totais / 3600;
+    int minutos_restantes = (segundos_totais % 3600) / 60;
+    int segundos_restantes = segundos_totais % 60;
+    char buffer[10];
+    sprintf(buffer, "%02d:%02d:%02d", horas_restantes, minutos_restantes, segundos_restantes);
+    desenha_barra_progresso(alarme_total_s - segundos_totais, alarme_total_s);
+    atualiza_area_texto(buffer, area_x, area_y, area_w, area_h);
+}
+
+void desenha_tela_alarme_armado() {
+    ssd1306_fill(&display, false);
+    desenha_moldura();
+    ssd1306_draw_string(&display, "Alarme", 10, 5);
+    desenha_icone(icone_sino);
+    desenha_contagem_alarme();
+}
+
+void desenha_alarme_tocando() {
     mostra_tela("Alarme!");
+    desenha_icone(icone_sino);
     ssd1306_draw_string(&display, "Clique A para", 10, 30);
     ssd1306_draw_string(&display, "desligar", 10, 40);
-    ssd1306_send_data(&display);
-    while (!flag_botaoA){
-        play_buzzer_tone();
-        verifica_bootsel();
-        sleep_ms(10);
+    atualiza_display();
+}
+
+// Conta até o prazo em segundo plano e, ao disparar, toma a tela até o A
+tarefa_estado_t tarefa_alarme(tarefa_t *t) {
+    static uint32_t versao;
+    TAREFA_INICIO(t);
+    while (true) {
+        TAREFA_ESPERA_ATE(t, alarme_armado);
+        versao = alarme_versao;
+        TAREFA_ESPERA_ATE_PRAZO(t, !alarme_armado || alarme_versao != versao, alarme_prazo_us);
+        if (!alarme_armado || alarme_versao != versao) continue;
+
+        alarme_armado = false;
+        diario_registra(EV_ALARME_TOCA, alarmes[alarme_indice].horas * 100 + alarmes[alarme_indice].minutos, 0);
+        remove_alarme(alarme_indice);
+        alarme_tocando = true;
+        flag_botaoA = false;
+        restaura_leds();
+        desenha_alarme_tocando();
+        buzzer_alarme = true;
+
+        TAREFA_ESPERA_ATE(t, flag_botaoA);
+        flag_botaoA = false;
+        latencia_atende_entrada();
+        flag_botaoB = false;
+        buzzer_alarme = false;
+        alarme_tocando = false;
+        arma_proximo_alarme();
+        restaura_leds();
+        if (desenha_tela_atual) desenha_tela_atual();
     }
-    flag_botaoA = false;
-    stop_buzzer_tone();
-    define_brilho_led(LED_VERMELHO, 0.0);
+    TAREFA_FIM(t);
 }
 
-void executar_pomodoro(int tempo_estudo, int tempo_pausa) {
+// ---------------------- POMODORO ---------------------------
+void desenha_contagem_pomodoro() {
     char buffer[20];
     int area_x = (LARGURA_TELA - 40) / 2;
     int area_y = 30, area_w = 40, area_h = 16;
-    
-    while (1) {
-         // Fase de estudos (brilho máximo para teste)
-         define_brilho_led(LED_VERDE, 1.0);
-         ssd1306_fill(&display, false);
-         desenha_moldura();
-         ssd1306_draw_string(&display, "Estudos", 10, 5);
-         sprintf(buffer, "%02d:00", tempo_estudo);
-         ssd1306_draw_string(&display, buffer, area_x, area_y);
-         ssd1306_send_data(&display);
-         
-         int segundos_estudo = tempo_estudo * 60;
-         while(segundos_estudo > 0) {
-              verifica_bootsel();
-              int min_restantes = segundos_estudo / 60;
-              int seg_restantes = segundos_estudo % 60;
-              sprintf(buffer, "%02d:%02d", min_restantes, seg_restantes);
-              atualiza_area_texto(buffer, area_x, area_y, area_w, area_h);
-              sleep_ms(1000);
-              segundos_estudo--;
-              if(flag_botaoB) {
-                   flag_botaoB = false;
-                   break;
-              }
-         }
-         define_brilho_led(LED_VERDE, 0.0);
-         if(flag_botaoB) {
-              flag_botaoB = false;
-              break;
-         }
-         
-         // Fase de pausa (LED vermelho e azul em brilho máximo)
-         define_brilho_led(LED_VERMELHO, 1.0);
-         ssd1306_fill(&display, false);
-         desenha_moldura();
-         ssd1306_draw_string(&display, "Pausa", 10, 5);
-         ssd1306_send_data(&display);
-         while (!flag_botaoA) {
-              play_buzzer_tone();
-              verifica_bootsel();
-         }
-         flag_botaoA = false;
-         define_brilho_led(LED_VERMELHO, 0.0);
-         
-         int segundos_pausa = tempo_pausa * 60;
-         define_brilho_led(LED_AZUL, 1.0);
-         while(segundos_pausa > 0) {
-              verifica_bootsel();
-              int min_restantes = segundos_pausa / 60;
-              int seg_restantes = segundos_pausa % 60;
-              sprintf(buffer, "%02d:%02d", min_restantes, seg_restantes);
-              atualiza_area_texto(buffer, area_x, area_y, area_w, area_h);
-              sleep_ms(1000);
-              segundos_pausa--;
-              if(flag_botaoB) {
-                   flag_botaoB = false;
-                   break;
-              }
-         }
-         define_brilho_led(LED_AZUL, 0.0);
-         if(flag_botaoB) {
-              flag_botaoB = false;
-              break;
-         }
-         
-         // Preparar novo ciclo de estudos
-         define_brilho_led(LED_VERMELHO, 1.0);
-         ssd1306_fill(&display, false);
-         desenha_moldura();
-         ssd1306_draw_string(&display, "Estudos", 10, 5);
-         ssd1306_send_data(&display);
-         while (!flag_botaoA) {
-            play_buzzer_tone();
-            verifica_bootsel();
-       }
-         if(flag_botaoB) {
-              flag_botaoB = false;
-              define_brilho_led(LED_VERMELHO, 0.0);
-              break;
-         }
-         flag_botaoA = false;
-         define_brilho_led(LED_VERMELHO, 0.0);
-         // Reinicia o ciclo pomodoro
+    int total = (int)pomodoro_duracao_fase_s(&pomodoro);
+    int restantes = (int)pomodoro_restante_s(&pomodoro, time_us_64());
+    sprintf(buffer, "%02d:%02d", restantes / 60, restantes % 60);
+    desenha_barra_progresso(total - restantes, total);
+    atualiza_area_texto(buffer, area_x, area_y, area_w, area_h);
+}
+
+void desenha_fase_pomodoro() {
+    const AcoesFase *acoes = &acoes_fase[pomodoro.fase];
+    const char *titulo = acoes->titulo;
+    if (pomodoro.fase == FASE_AGUARDA_PAUSA && pomodoro_pausa_longa_a_seguir(&pomodoro)) {
+        titulo = acoes_fase[FASE_PAUSA_LONGA].titulo;
+    }
+    ssd1306_fill(&display, false);
+    desenha_moldura();
+    ssd1306_draw_string(&display, titulo, 10, 5);
+    desenha_icone(acoes->icone);
+    char linha[20];
+    if (pomodoro.fase != FASE_CONCLUIDO) {
+        snprintf(linha, sizeof(linha), "Ciclo %d/%d", pomodoro.ciclo + 1, pomodoro.cronograma.ciclos);
+    } else {
+        // Só sessões com fim chegam aqui: tempo total de estudo e pausas
+        uint32_t total_s = pomodoro_duracao_sessao_s(&pomodoro.cronograma);
+        snprintf(linha, sizeof(linha), "Total %luh%02lu", (unsigned long)(total_s / 3600),
+                 (unsigned long)(total_s / 60 % 60));
+    }
+    ssd1306_draw_string(&display, linha, 10, 17);
+    if (pomodoro_fase_com_contagem(pomodoro.fase)) {
+        desenha_contagem_pomodoro();
+    } else {
+        atualiza_display();
     }
 }
 
-int main() {
-    stdio_init_all();
-    
-    configura_componentes();
-    configura_pwm_no_pino(LED_VERDE);
-    configura_pwm_no_pino(LED_AZUL);
-    configura_pwm_no_pino(LED_VERMELHO);
-    
-    ssd1306_init_config_clean(&display, SCL_I2C, SDA_I2C, PORTA_I2C, OLED_ENDERECO);
-    ssd1306_config(&display);
-    
-    while (1) {
+// Aplica as ações da fase em que o pomodoro acabou de entrar
+void entra_fase_pomodoro(bool por_tempo) {
+    const AcoesFase *acoes = &acoes_fase[pomodoro.fase];
+    diario_registra(EV_FASE_POMODORO, pomodoro.fase, pomodoro.ciclo);
+    bool aviso = (acoes->tom == TOM_AVISO && por_tempo);
+    buzzer_pomodoro = (acoes->tom == TOM_CONTINUO) || aviso;
+    aviso_fim_us = aviso ? time_us_64() + AVISO_US : TAREFA_SEM_PRAZO;
+    if (pomodoro_aguardando(&pomodoro)) flag_botaoA = false;   // confirma só o próximo toque
+    restaura_leds();
+    entra_tela(desenha_fase_pomodoro);
+}
+
+// Próximo instante em que a tarefa precisa agir: virada do segundo da
+// contagem (que inclui o fim da fase) ou fim do bipe
+uint64_t proximo_evento_pomodoro() {
+    uint64_t prazo = aviso_fim_us;
+    if (pomodoro_fase_com_contagem(pomodoro.fase)) {
+        uint64_t segundo = proximo_segundo(pomodoro.fim_us);
+        if (segundo < prazo) prazo = segundo;
+    }
+    return prazo;
+}
+
+// Executa cronograma_ativo até pomodoro_ativo cair. As transições vêm de
+// inc/pomodoro.c; aqui só se espera por prazos ou pelo A, sem dormir.
+tarefa_estado_t tarefa_pomodoro(tarefa_t *t) {
+    TAREFA_INICIO(t);
+    while (true) {
+        TAREFA_ESPERA_ATE(t, pomodoro_ativo);
+        pomodoro_inicia(&pomodoro, &cronograma_ativo, time_us_64());
+        entra_fase_pomodoro(false);
+
+        while (pomodoro_ativo) {
+            TAREFA_ESPERA_ATE_PRAZO(t, !pomodoro_ativo ||
+                                       (pomodoro_aguardando(&pomodoro) && botao_pendente(&flag_botaoA)),
+                                    proximo_evento_pomodoro());
+            if (!pomodoro_ativo) break;
+
+            uint64_t agora = time_us_64();
+            if (pomodoro_aguardando(&pomodoro) && consome_botao(&flag_botaoA)) {
+                pomodoro_confirma(&pomodoro, agora);
+                entra_fase_pomodoro(false);
+            } else if (pomodoro_atualiza(&pomodoro, agora)) {
+                entra_fase_pomodoro(true);
+            } else if (pomodoro_fase_com_contagem(pomodoro.fase) && tela_livre()) {
+                desenha_contagem_pomodoro();
+            }
+            if (agora >= aviso_fim_us) {
+                aviso_fim_us = TAREFA_SEM_PRAZO;
+                buzzer_pomodoro = (acoes_fase[pomodoro.fase].tom == TOM_CONTINUO);
+            }
+        }
+
+        buzzer_pomodoro = false;
+        aviso_fim_us = TAREFA_SEM_PRAZO;
+        restaura_leds();
+    }
+    TAREFA_FIM(t);
+}
+
+// ---------------------- PROTOCOLO USB ---------------------------
+// Configuração e consulta pelo protocolo binário de inc/protocolo.h
+// (cliente em tools/protocolo.py).
+#define PROTO_BYTES_POR_RODADA 64   // limita o trabalho por rodada do escalonador
+
+static volatile bool usb_rx_pendente = false;
+
+// Chamada pela stdio (em interrupção) quando chegam bytes
+void usb_dados_chegaram(void *param) {
+    (void)param;
+    usb_rx_pendente = true;
+    tarefas_sinaliza();
+}
+
+// Cabem `n` bytes no buffer de transmissão da CDC agora?
+bool usb_cabe(size_t n) {
+#if LIB_PICO_STDIO_USB
+    return stdio_usb_connected() && tud_cdc_write_available() >= n;
+#else
+    (void)n;
+    return false;
+#endif
+}
+
+// Quadros vão só para a CDC (a UART fica com o texto do printf) e nunca
+// esperam: sem espaço na transmissão o quadro é descartado e retorna false.
+// Com espaço, o driver da stdio USB copia e despacha sem bloquear.
+bool envia_quadro(uint8_t tipo, const void *dados, uint8_t tamanho) {
+    uint8_t quadro[PROTO_MAX_QUADRO];
+    size_t n = protocolo_monta(quadro, tipo, dados, tamanho);
+    if (!usb_cabe(n)) return false;
+#if LIB_PICO_STDIO_USB
+    stdio_usb.out_chars((const char *)quadro, (int)n);
+#endif
+    return true;
+}
+
+protocolo_status_t aplica_relogio(const protocolo_msg_t *msg) {
+    const uint8_t *d = msg->dados;
+    if (msg->tamanho != 3 || d[0] >= 24 || d[1] >= 60 || d[2] >= 60) return PROTO_INVALIDO;
+    acerta_relogio(d[0], d[1], d[2]);
+    if (num_alarmes > 0) arma_proximo_alarme();
+    return PROTO_OK;
+}
+
+protocolo_status_t aplica_alarmes(const protocolo_msg_t *msg) {
+    Horario lista[ALARMES_MAX];
+    const uint8_t *d = msg->dados;
+    if (msg->tamanho < 1 || d[0] > ALARMES_MAX || msg->tamanho != 1 + 2 * d[0]) return PROTO_INVALIDO;
+    for (int i = 0; i < d[0]; i++) {
+        lista[i] = (Horario){d[1 + 2 * i], d[2 + 2 * i]};
+        if (lista[i].horas >= 24 || lista[i].minutos >= 60) return PROTO_INVALIDO;
+    }
+    define_alarmes(lista, d[0]);
+    return PROTO_OK;
+}
+
+protocolo_status_t aplica_presets(const protocolo_msg_t *msg) {
+    const uint8_t *d = msg->dados;
+    if (msg->tamanho < 1 || d[0] > PRESETS_MAX || msg->tamanho != 1 + PROTO_PRESET_BYTES * d[0]) return PROTO_INVALIDO;
+    for (int i = 0; i < d[0]; i++) {
+        // Até 99 minutos ("99/99" ainda cabe no menu) e 9 ciclos ("Ciclo 9/9")
+        const uint8_t *p = &d[1 + PROTO_PRESET_BYTES * i];
+        if (p[0] < 1 || p[0] > 99 || p[1] < 1 || p[1] > 99 || p[2] < 1 || p[2] > 9 ||
+            p[3] > 99 || p[4] > 99 || (p[5] & ~PROTO_PRESET_AUTOMATICO)) return PROTO_INVALIDO;
+    }
+    if (d[0] == 0) {
+        restaura_presets();
+    } else {
+        for (int i = 0; i < d[0]; i++) {
+            const uint8_t *p = &d[1 + PROTO_PRESET_BYTES * i];
+            presets_pomodoro[i] = (cronograma_t){p[0], p[1], p[2], p[3], p[4], (p[5] & PROTO_PRESET_AUTOMATICO) != 0};
+        }
+        num_presets = d[0];
+    }
+    if (selecao_pomodoro >= num_presets) selecao_pomodoro = 0;
+    return PROTO_OK;
+}
+
+void preenche_estado(protocolo_estado_t *e) {
+    uint32_t agora_s = segundos_do_dia();
+    e->estado = (uint8_t)estado_atual;
+    e->horas = agora_s / 3600;
+    e->minutos = (agora_s / 60) % 60;
+    e->segundos = agora_s % 60;
+    e->alarme_armado = alarme_armado;
+    e->num_alarmes = (uint8_t)num_alarmes;
+    e->alarme_restante_s = alarme_armado ? (uint32_t)segundos_ate(alarme_prazo_us) : 0;
+    e->pomodoro_ativo = pomodoro_ativo;
+    e->fase_pomodoro = (uint8_t)pomodoro.fase;
+    e->ciclo_pomodoro = pomodoro.ciclo;
+    e->fase_restante_s = pomodoro_ativo ? pomodoro_restante_s(&pomodoro, time_us_64()) : 0;
+    e->num_presets = (uint8_t)num_presets;
+    e->preset_selecionado = (uint8_t)selecao_pomodoro;
+}
+
+// Texto de um evento do diário, direto da tabela na flash
+void envia_formato(const protocolo_msg_t *msg) {
+    uint8_t resposta[PROTO_MAX_DADOS];
+    resposta[0] = DIARIO_NUM_EVENTOS;
+    const char *formato = (msg->tamanho == 1) ? diario_formato(msg->dados[0]) : NULL;
+    if (!formato) {
+        envia_quadro(PROTO_FORMATO | PROTO_RESPOSTA, resposta, 1);
+        return;
+    }
+    size_t n = strnlen(formato, PROTO_MAX_DADOS - 2);
+    resposta[1] = msg->dados[0];
+    memcpy(&resposta[2], formato, n);
+    envia_quadro(PROTO_FORMATO | PROTO_RESPOSTA, resposta, (uint8_t)(2 + n));
+}
+
+void trata_mensagem(const protocolo_msg_t *msg) {
+    if (msg->tipo == PROTO_FORMATO) {
+        envia_formato(msg);
+        return;
+    }
+    if (msg->tipo == PROTO_CONSULTA) {
+        protocolo_estado_t estado;
+        preenche_estado(&estado);
+        envia_quadro(PROTO_CONSULTA | PROTO_RESPOSTA, &estado, sizeof(estado));
+        return;
+    }
+
+    uint8_t status;
+    if (msg->tipo == PROTO_RELOGIO) {
+        status = aplica_relogio(msg);
+    } else if (msg->tipo == PROTO_ALARMES) {
+        status = aplica_alarmes(msg);
+    } else if (msg->tipo == PROTO_PRESETS) {
+        status = aplica_presets(msg);
+    } else {
+        status = PROTO_DESCONHECIDO;
+    }
+    diario_registra(EV_PROTOCOLO, msg->tipo, status);
+    // A tela atual pode mostrar o que mudou (sino, menu de presets, contagem)
+    if (status == PROTO_OK && desenha_tela_atual && tela_livre()) desenha_tela_atual();
+    envia_quadro(msg->tipo | PROTO_RESPOSTA, &status, 1);
+}
+
+// Consome só o que já chegou (getchar_timeout_us(0) nunca bloqueia). Acorda
+// pelo aviso da stdio e, como reserva, a cada 100 ms, que também é quando um
+// quadro parcial expirado é abandonado.
+tarefa_estado_t tarefa_protocolo(tarefa_t *t) {
+    static protocolo_rx_t rx;
+    TAREFA_INICIO(t);
+    protocolo_rx_inicia(&rx);
+    stdio_set_chars_available_callback(usb_dados_chegaram, NULL);
+    while (true) {
+        TAREFA_ESPERA_ATE_PRAZO(t, usb_rx_pendente, time_us_64() + 100000);
+        usb_rx_pendente = false;
+        int lidos = 0;
+        uint32_t agora_ms = to_ms_since_boot(get_absolute_time());
+        protocolo_msg_t msg;
+        while (lidos < PROTO_BYTES_POR_RODADA) {
+            int c = getchar_timeout_us(0);
+            if (c < 0) break;
+            lidos++;
+            protocolo_recebe(&rx, (uint8_t)c, agora_ms);
+            while (protocolo_proximo(&rx, agora_ms, &msg)) trata_mensagem(&msg);
+        }
+        while (protocolo_proximo(&rx, agora_ms, &msg)) trata_mensagem(&msg);
+        // Ainda pode haver bytes: continua na próxima rodada
+        if (lidos == PROTO_BYTES_POR_RODADA) usb_rx_pendente = true;
+    }
+    TAREFA_FIM(t);
+}
+
+// ---------------------- TAREFAS DE E/S ---------------------------
+tarefa_estado_t tarefa_entrada(tarefa_t *t) {
+    TAREFA_INICIO(t);
+    while (true) {
         verifica_bootsel();
-        switch (estado_atual) {
-            case ESTADO_BEM_VINDO:
-                mostrar_boas_vindas();
-                while (!flag_botaoA) { verifica_bootsel(); sleep_ms(100); }
-                flag_botaoA = false;
-                estado_atual = ESTADO_MENU_PRINCIPAL;
-                break;
-            case ESTADO_MENU_PRINCIPAL: {
-                    desenha_menu_principal();
-                    // Ignorando o botão B neste menu
-                    while(!flag_botaoA) {
-                        DirecaoJoystick direcao = le_joystick();
-                        if (direcao == JOY_CIMA || direcao == JOY_ESQUERDA ||
-                            direcao == JOY_BAIXO || direcao == JOY_DIREITA) {
-                            selecao_menu_principal = (selecao_menu_principal + 1) % 2;
-                            desenha_seta_menu_principal(selecao_menu_principal);
-                            sleep_ms(200);
-                        }
-                        if(flag_botaoB) {
-                            flag_botaoB = false;
-                        }
-                        verifica_bootsel();
-                        sleep_ms(50);
-                    }
-                    flag_botaoA = false;
-                    estado_atual = (selecao_menu_principal == 0) ? ESTADO_EDITAR_HORA_ATUAL : ESTADO_MENU_POMODORO;
-                }
-                break;
-            case ESTADO_EDITAR_HORA_ATUAL:
-                horario_atual = editar_horario("Hora Atual", false);
-                if (edicao_cancelada) { 
-                    estado_atual = ESTADO_MENU_PRINCIPAL; 
-                    break; 
+        direcao_joystick = le_joystick();
+        TAREFA_DORME_MS(t, 20);
+    }
+    TAREFA_FIM(t);
+}
+
+tarefa_estado_t tarefa_buzzer(tarefa_t *t) {
+    TAREFA_INICIO(t);
+    while (true) {
+        TAREFA_ESPERA_ATE(t, buzzer_alarme || buzzer_pomodoro);
+        start_buzzer_tone();
+        while (buzzer_alarme || buzzer_pomodoro) {
+            set_buzzer_level(BUZZER_NIVEL_SOM);   // Som por 500 ms
+            TAREFA_ESPERA_ATE_PRAZO(t, !(buzzer_alarme || buzzer_pomodoro), time_us_64() + 500000);
+            set_buzzer_level(0);                  // Silêncio por 500 ms
+            TAREFA_ESPERA_ATE_PRAZO(t, !(buzzer_alarme || buzzer_pomodoro), time_us_64() + 500000);
+        }
+        stop_buzzer_tone();
+    }
+    TAREFA_FIM(t);
+}
+
+tarefa_estado_t tarefa_display(tarefa_t *t) {
+    TAREFA_INICIO(t);
+    while (true) {
+        TAREFA_ESPERA_ATE(t, display_sujo);
+        display_sujo = false;
+        envia_display();
+    }
+    TAREFA_FIM(t);
+}
+
+// ---------------------- INTERFACE (MÁQUINA DE ESTADOS) ---------------------------
+tarefa_estado_t tarefa_ui(tarefa_t *t) {
+    static tarefa_t subtarefa;
+    static EstadoAplicacao estado_anterior = ESTADO_BEM_VINDO;
+    TAREFA_INICIO(t);
+    while (true) {
+        latencia_define_tela(estado_atual);
+        if (estado_atual != estado_anterior) {
+            diario_registra(EV_ESTADO, estado_anterior, estado_atual);
+            estado_anterior = estado_atual;
+        }
+
+        if (estado_atual == ESTADO_BEM_VINDO) {
+            // No boot a tela de boas-vindas já foi enviada por main()
+            if (desenha_tela_atual != mostrar_boas_vindas) entra_tela(mostrar_boas_vindas);
+            TAREFA_ESPERA_ATE(t, consome_botao(&flag_botaoA));
+            estado_atual = ESTADO_MENU_PRINCIPAL;
+
+        } else if (estado_atual == ESTADO_MENU_PRINCIPAL) {
+            latencia_despeja();
+            entra_tela(desenha_menu_principal);
+            // Ignorando o botão B neste menu
+            while (true) {
+                TAREFA_ESPERA_ATE(t, direcao_joystick != JOY_NENHUM ||
+                                     botao_pendente(&flag_botaoA) || botao_pendente(&flag_botaoB));
+                if (consome_botao(&flag_botaoA)) break;
+                consome_botao(&flag_botaoB);
+                if (direcao_joystick != JOY_NENHUM) {
+                    latencia_atende_entrada();
+                    selecao_menu_principal = (selecao_menu_principal + 1) % 2;
+                    if (tela_livre()) desenha_seta_menu_principal(selecao_menu_principal);
+                    TAREFA_DORME_MS(t, 250);
                 }
+            }
+            estado_atual = (selecao_menu_principal == 0) ? ESTADO_EDITAR_HORA_ATUAL : ESTADO_MENU_POMODORO;
+
+        } else if (estado_atual == ESTADO_EDITAR_HORA_ATUAL) {
+            TAREFA_EXECUTA(t, &subtarefa, editar_horario(&subtarefa, "Hora Atual"));
+            if (edicao_cancelada) {
+                estado_atual = ESTADO_MENU_PRINCIPAL;
+            } else {
+                acerta_relogio(horario_editado.horas, horario_editado.minutos, 0);
+                // Os prazos já armados contavam do horário antigo
+                if (num_alarmes > 0) arma_proximo_alarme();
                 estado_atual = ESTADO_EDITAR_ALARME;
-                break;
-            case ESTADO_EDITAR_ALARME:
-                horario_alarme = editar_horario("Alarme", false);
-                if (edicao_cancelada) { 
-                    estado_atual = ESTADO_MENU_PRINCIPAL; 
-                    break; 
-                }
-                executar_alarme(horario_atual, horario_alarme);
+            }
+
+        } else if (estado_atual == ESTADO_EDITAR_ALARME) {
+            TAREFA_EXECUTA(t, &subtarefa, editar_horario(&subtarefa, "Alarme"));
+            if (edicao_cancelada) {
                 estado_atual = ESTADO_MENU_PRINCIPAL;
-                break;
-            case ESTADO_MENU_POMODORO: {
-                    desenha_menu_pomodoro();
-                    while(!flag_botaoA && !flag_botaoB) {
-                        DirecaoJoystick direcao = le_joystick();
-                        if (direcao == JOY_CIMA || direcao == JOY_ESQUERDA) {
-                            selecao_pomodoro = (selecao_pomodoro + 3) % 4;
-                            desenha_seta_menu_pomodoro(selecao_pomodoro);
-                            sleep_ms(200);
-                        } else if (direcao == JOY_BAIXO || direcao == JOY_DIREITA) {
-                            selecao_pomodoro = (selecao_pomodoro + 1) % 4;
-                            desenha_seta_menu_pomodoro(selecao_pomodoro);
-                            sleep_ms(200);
-                        }
-                        verifica_bootsel();
-                        sleep_ms(50);
-                    }
-                    flag_botaoA = false;
-                    {
-                        int tempo_estudo = 25, tempo_pausa = 5;
-                        switch (selecao_pomodoro) {
-                            case 0: tempo_estudo = 25; tempo_pausa = 5; break;
-                            case 1: tempo_estudo = 30; tempo_pausa = 15; break;
-                            case 2: tempo_estudo = 40; tempo_pausa = 20; break;
-                            case 3: tempo_estudo = 60; tempo_pausa = 30; break;
-                        }
-                        executar_pomodoro(tempo_estudo, tempo_pausa);
-                    }
-                    estado_atual = ESTADO_MENU_PRINCIPAL;
+            } else {
+                horario_alarme = horario_editado;
+                adiciona_alarme(horario_alarme);
+                estado_atual = ESTADO_CONTAGEM_ALARME;
+            }
+
+        } else if (estado_atual == ESTADO_CONTAGEM_ALARME) {
+            // Mostra o próximo alarme da lista. B cancela só ele (os outros
+            // continuam); A volta ao menu com o alarme armado
+            entra_tela(desenha_tela_alarme_armado);
+            while (alarme_armado) {
+                TAREFA_ESPERA_ATE_PRAZO(t, !alarme_armado || botao_pendente(&flag_botaoA) ||
+                                           botao_pendente(&flag_botaoB),
+                                        proximo_segundo(alarme_prazo_us));
+                if (consome_botao(&flag_botaoB)) {
+                    cancela_alarme_armado();
+                    break;
+                }
+                if (consome_botao(&flag_botaoA)) break;
+                if (alarme_armado && tela_livre()) desenha_contagem_alarme();
+            }
+            estado_atual = ESTADO_MENU_PRINCIPAL;
+
+        } else if (estado_atual == ESTADO_MENU_POMODORO) {
+            entra_tela(desenha_menu_pomodoro);
+            while (true) {
+                TAREFA_ESPERA_ATE(t, direcao_joystick != JOY_NENHUM ||
+                                     botao_pendente(&flag_botaoA) || botao_pendente(&flag_botaoB));
+                if (botao_pendente(&flag_botaoA) || botao_pendente(&flag_botaoB)) break;
+                latencia_atende_entrada();
+                if (direcao_joystick == JOY_CIMA || direcao_joystick == JOY_ESQUERDA) {
+                    selecao_pomodoro = (selecao_pomodoro + num_presets - 1) % num_presets;
+                } else {
+                    selecao_pomodoro = (selecao_pomodoro + 1) % num_presets;
                 }
-                break;
-            default:
+                if (tela_livre()) desenha_seta_menu_pomodoro(selecao_pomodoro);
+                TAREFA_DORME_MS(t, 250);
+            }
+            if (consome_botao(&flag_botaoB)) {
                 estado_atual = ESTADO_MENU_PRINCIPAL;
-                break;
+            } else {
+                consome_botao(&flag_botaoA);
+                cronograma_ativo = presets_pomodoro[selecao_pomodoro];
+                estado_atual = ESTADO_POMODORO;
+            }
+
+        } else if (estado_atual == ESTADO_POMODORO) {
+            pomodoro_ativo = true;
+            tarefas_sinaliza();
+            TAREFA_ESPERA_ATE(t, consome_botao(&flag_botaoB));
+            pomodoro_ativo = false;
+            tarefas_sinaliza();
+            estado_atual = ESTADO_MENU_PRINCIPAL;
+
+        } else {
+            estado_atual = ESTADO_MENU_PRINCIPAL;
         }
-        sleep_ms(50);
     }
+    TAREFA_FIM(t);
+}
+
+// ---------------------- BOOT ---------------------------
+// Etapas do boot com o instante (us desde o reset) em que cada uma terminou.
+// O primeiro quadro vem antes de tudo o que não é display; o relatório sai
+// pela stdio quando a USB conecta (ou após BOOT_ESPERA_USB_MS, pela UART).
+#define BOOT_ORCAMENTO_US   50000   // reset -> boas-vindas visível
+#define BOOT_ESPERA_USB_MS  5000
+
+typedef enum {
+    BOOT_MAIN,
+    BOOT_DISPLAY_CONFIGURADO,
+    BOOT_PRIMEIRO_QUADRO,
+    BOOT_PERIFERICOS,
+    BOOT_STDIO,
+    NUM_ETAPAS_BOOT
+} EtapaBoot;
+
+static const char *const nomes_etapas_boot[NUM_ETAPAS_BOOT] = {
+    "main", "display_configurado", "primeiro_quadro", "perifericos", "stdio"
+};
+uint32_t marcos_boot_us[NUM_ETAPAS_BOOT];
+
+void marca_boot(EtapaBoot etapa) {
+    marcos_boot_us[etapa] = time_us_32();
+}
+
+// Linhas "BOOT,etapa,t_us,delta_us" e o resumo do primeiro quadro
+void relata_boot() {
+    uint32_t anterior = 0;
+    for (int i = 0; i < NUM_ETAPAS_BOOT; i++) {
+        printf("BOOT,%s,%lu,%lu\n", nomes_etapas_boot[i], (unsigned long)marcos_boot_us[i],
+               (unsigned long)(marcos_boot_us[i] - anterior));
+        anterior = marcos_boot_us[i];
+    }
+    uint32_t primeiro_quadro = marcos_boot_us[BOOT_PRIMEIRO_QUADRO];
+    printf("BOOT_PRIMEIRO_QUADRO,%lu,%lu,%s\n", (unsigned long)primeiro_quadro,
+           (unsigned long)BOOT_ORCAMENTO_US, primeiro_quadro <= BOOT_ORCAMENTO_US ? "OK" : "ESTOURO");
+}
+
+bool usb_conectada() {
+#if LIB_PICO_STDIO_USB
+    return stdio_usb_connected();
+#else
+    return false;
+#endif
+}
+
+tarefa_estado_t tarefa_relatorio_boot(tarefa_t *t) {
+    static uint64_t limite;
+    TAREFA_INICIO(t);
+    limite = time_us_64() + (uint64_t)BOOT_ESPERA_USB_MS * 1000;
+    while (!usb_conectada() && time_us_64() < limite) {
+        TAREFA_DORME_MS(t, 100);
+    }
+    relata_boot();
+    TAREFA_ESPERA_ATE(t, false);
+    TAREFA_FIM(t);
+}
+
+// ---------------------- DIÁRIO ---------------------------
+// Escoa o diário (inc/diario.h) pela USB em quadros PROTO_DIARIO. É a última
+// tarefa da rodada e manda no máximo um quadro por rodada, só quando ele
+// cabe inteiro na transmissão da CDC; sem USB (ou com o host sem ler) os
+// registros ficam no anel (os mais recentes) até alguém conectar.
+#define DIARIO_POR_QUADRO   ((PROTO_MAX_DADOS - sizeof(uint32_t)) / sizeof(diario_registro_t))
+#define DIARIO_INTERVALO_MS 200
+
+tarefa_estado_t tarefa_diario(tarefa_t *t) {
+    static struct {
+        uint32_t perdidos;   // acumulado desde o boot
+        diario_registro_t registros[DIARIO_POR_QUADRO];
+    } quadro;
+    TAREFA_INICIO(t);
+    while (true) {
+        TAREFA_ESPERA_ATE_PRAZO(t, usb_cabe(PROTO_MAX_QUADRO) && diario_pendentes() >= DIARIO_POR_QUADRO,
+                                time_us_64() + (uint64_t)DIARIO_INTERVALO_MS * 1000);
+        if (!usb_cabe(PROTO_MAX_QUADRO)) continue;
+        uint n = diario_retira(quadro.registros, DIARIO_POR_QUADRO, &quadro.perdidos);
+        if (n > 0) envia_quadro(PROTO_DIARIO, &quadro, (uint8_t)(sizeof(uint32_t) + n * sizeof(diario_registro_t)));
+    }
+    TAREFA_FIM(t);
+}
+
+static tarefa_t ctx_entrada, ctx_protocolo, ctx_alarme, ctx_pomodoro, ctx_buzzer, ctx_ui, ctx_display, ctx_boot,
+                ctx_diario;
+
+int main() {
+    marca_boot(BOOT_MAIN);
+    diario_inicia();
+    restaura_presets();
+
+    // 1) Só o display: configuração em uma transação, painel desligado
+    ssd1306_init_config(&display, SCL_I2C, SDA_I2C, PORTA_I2C, OLED_ENDERECO);
+    marca_boot(BOOT_DISPLAY_CONFIGURADO);
+
+    // 2) Boas-vindas composta no buffer, um envio e painel ligado
+    compoe_boas_vindas();
+    ssd1306_send_data(&display);
+    ssd1306_power(&display, true);
+    desenha_tela_atual = mostrar_boas_vindas;
+    marca_boot(BOOT_PRIMEIRO_QUADRO);
+
+    // 3) Restante do hardware e, por último, USB/UART (enumeração é lenta)
+    configura_componentes();
+    latencia_inicia(trata_interrupcao_gpio);
+    marca_boot(BOOT_PERIFERICOS);
+    stdio_init_all();
+    marca_boot(BOOT_STDIO);
+
+    // A ordem é a ordem de execução em cada rodada: entradas primeiro,
+    // display depois para enviar tudo o que foi desenhado na rodada, e o
+    // diário no fim, com o que sobrou de tempo.
+    tarefas_adiciona(&ctx_entrada, tarefa_entrada);
+    tarefas_adiciona(&ctx_protocolo, tarefa_protocolo);
+    tarefas_adiciona(&ctx_alarme, tarefa_alarme);
+    tarefas_adiciona(&ctx_pomodoro, tarefa_pomodoro);
+    tarefas_adiciona(&ctx_buzzer, tarefa_buzzer);
+    tarefas_adiciona(&ctx_ui, tarefa_ui);
+    tarefas_adiciona(&ctx_display, tarefa_display);
+    tarefas_adiciona(&ctx_boot, tarefa_relatorio_boot);
+    tarefas_adiciona(&ctx_diario, tarefa_diario);
+    tarefas_executa();
     return 0;
 }
@@ -0,0 +1,42 @@
+#include "botoes_pio.h"
+#include "hardware/irq.h"
+#include "botoes.pio.h"
+
+static PIO pio_botoes;
+static uint pinos_botoes[BOTOES_MAX];
+static uint num_botoes = 0;
+static botoes_callback_t callback_botoes = NULL;
+
+static void trata_irq_botoes(void) {
+    for (uint sm = 0; sm < num_botoes; sm++) {
+        while (!pio_sm_is_rx_fifo_empty(pio_botoes, sm)) {
+            bool pressionado;
+            uint32_t tick;
+            botoes_pio_decodifica(pio_sm_get(pio_botoes, sm), &pressionado, &tick);
+            callback_botoes(pinos_botoes[sm], pressionado, tick);
+        }
+    }
+}
+
+void botoes_pio_inicia(PIO pio, const uint *pinos, uint num_pinos, botoes_callback_t callback) {
+    if (num_pinos > BOTOES_MAX) panic("botoes_pio: no maximo %d botoes", BOTOES_MAX);
+    pio_botoes = pio;
+    num_botoes = num_pinos;
+    callback_botoes = callback;
+
+    uint offset = pio_add_program(pio, &botoes_program);
+    uint mascara = 0;
+    for (uint sm = 0; sm < num_pinos; sm++) {
+        pio_sm_claim(pio, sm);
+        pinos_botoes[sm] = pinos[sm];
+        botoes_program_init(pio, sm, offset, pinos[sm], BOTOES_AMOSTRAS_POR_SEGUNDO);
+        pio_set_irq0_source_enabled(pio, pio_get_rx_fifo_not_empty_interrupt_source(sm), true);
+        mascara |= 1u << sm;
+    }
+
+    uint irq = pio_get_irq_num(pio, 0);
+    irq_set_exclusive_handler(irq, trata_irq_botoes);
+    irq_set_enabled(irq, true);
+    // Todos os SMs partem juntos, então os ticks dos botões são comparáveis
+    pio_enable_sm_mask_in_sync(pio, mascara);
+}
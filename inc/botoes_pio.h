@@ -0,0 +1,25 @@
+#ifndef BOTOES_PIO_H
+#define BOTOES_PIO_H
+
+// Debounce dos botões em PIO (inc/botoes.pio): o SM amostra cada botão a
+// BOTOES_AMOSTRAS_POR_SEGUNDO e só empurra eventos limpos de aperto/soltura,
+// com o número da amostra como carimbo de tempo. A CPU recebe uma IRQ por
+// evento real, não por borda de oscilação.
+
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+
+#define BOTOES_AMOSTRAS_POR_SEGUNDO 1000   // 1 tick = 1 ms
+#define BOTOES_MAX 4                        // um SM por botão
+
+typedef void (*botoes_callback_t)(uint gpio, bool pressionado, uint32_t tick);
+
+void botoes_pio_inicia(PIO pio, const uint *pinos, uint num_pinos, botoes_callback_t callback);
+
+// Separa a palavra do RX FIFO em nível e tick (amostras desde o início)
+static inline void botoes_pio_decodifica(uint32_t palavra, bool *pressionado, uint32_t *tick) {
+    *pressionado = (palavra & 1u) == 0;
+    *tick = (0u - (palavra >> 1)) & 0x7FFFFFFFu;   // X começa em 0 e decrementa
+}
+
+#endif
@@ -0,0 +1,86 @@
+#include "diario.h"
+#include "hardware/sync.h"
+
+#define SEQ(indice) ((uint16_t)(DIARIO_PUBLICADO | ((indice) & 0x7FFFu)))
+
+// Ponteiros e textos const: ficam na flash (XIP), não ocupam RAM
+#define DIARIO_FORMATO(id, formato) formato,
+static const char *const formatos[DIARIO_NUM_EVENTOS] = {
+    DIARIO_EVENTOS(DIARIO_FORMATO)
+};
+#undef DIARIO_FORMATO
+
+_Static_assert(sizeof(diario_registro_t) == 16, "registro do diário deve ter 16 bytes");
+_Static_assert((DIARIO_CAPACIDADE & (DIARIO_CAPACIDADE - 1)) == 0, "capacidade deve ser potência de 2");
+
+static volatile diario_registro_t anel[DIARIO_CAPACIDADE];
+static volatile uint32_t escrita = 0;   // total de posições já reservadas
+static uint32_t lidos = 0;              // só o consumidor mexe
+static spin_lock_t *trava = NULL;
+
+void diario_inicia(void) {
+    trava = spin_lock_instance(spin_lock_claim_unused(true));
+}
+
+void diario_registra(diario_evento_t evento, uint32_t a, uint32_t b) {
+    if (!trava) return;   // antes de diario_inicia()
+
+    // Reserva: índice, carimbo e invalidação da posição. Com o tempo lido
+    // aqui dentro, a ordem do anel é também a ordem dos carimbos.
+    uint32_t estado = spin_lock_blocking(trava);
+    uint32_t indice = escrita;
+    uint32_t tempo = time_us_32();
+    volatile diario_registro_t *r = &anel[indice & (DIARIO_CAPACIDADE - 1)];
+    r->seq = 0;
+    __dmb();
+    escrita = indice + 1;
+    spin_unlock(trava, estado);
+
+    r->tempo_us = tempo;
+    r->evento = (uint8_t)evento;
+    r->nucleo = (uint8_t)get_core_num();
+    r->a = a;
+    r->b = b;
+    __dmb();
+    r->seq = SEQ(indice);   // publica
+}
+
+uint diario_pendentes(void) {
+    uint32_t n = escrita - lidos;
+    return n > DIARIO_CAPACIDADE ? DIARIO_CAPACIDADE : n;
+}
+
+uint diario_retira(diario_registro_t *saida, uint max, uint32_t *perdidos) {
+    uint n = 0;
+    while (n < max) {
+        uint32_t escritos = escrita;
+        __dmb();
+        if (escritos == lidos) break;
+        if (escritos - lidos > DIARIO_CAPACIDADE) {
+            *perdidos += escritos - lidos - DIARIO_CAPACIDADE;
+            lidos = escritos - DIARIO_CAPACIDADE;
+        }
+
+        volatile diario_registro_t *r = &anel[lidos & (DIARIO_CAPACIDADE - 1)];
+        uint16_t esperado = SEQ(lidos);
+        uint16_t seq = r->seq;
+        if (seq == 0) break;          // produtor ainda escrevendo: volta depois
+        if (seq == esperado) {
+            saida[n] = *r;
+            __dmb();
+            if (r->seq == esperado) {
+                n++;
+                lidos++;
+                continue;
+            }
+        }
+        // Sobrescrito por uma volta mais nova do anel (antes ou durante a cópia)
+        (*perdidos)++;
+        lidos++;
+    }
+    return n;
+}
+
+const char *diario_formato(uint evento) {
+    return evento < DIARIO_NUM_EVENTOS ? formatos[evento] : NULL;
+}
@@ -0,0 +1,72 @@
+#ifndef DIARIO_H
+#define DIARIO_H
+
+// Diário de eventos: log binário adiado, seguro em interrupções.
+//
+// diario_registra() grava só um registro de 16 bytes (tempo, evento, dois
+// argumentos) em um anel na RAM; nada é formatado nem enviado ali. O texto de
+// cada evento fica em uma tabela na flash (DIARIO_EVENTOS) e só o host o usa:
+// a tarefa de escoamento manda os registros em quadros PROTO_DIARIO e
+// tools/diario.py pede os formatos (PROTO_FORMATO) e monta as linhas.
+//
+// Produtores: qualquer contexto (tarefas, ISR, os dois núcleos). A reserva da
+// posição é a única parte exclusiva: o M0+ não tem LDREX/STREX, então ela usa
+// um spinlock de hardware com as interrupções desligadas por algumas
+// instruções. O preenchimento acontece fora dele e é publicado pelo campo
+// `seq` (escrito por último), então o leitor nunca vê um registro pela metade.
+// Anel cheio sobrescreve o mais antigo; o leitor conta o que perdeu.
+//
+// Consumidor: um só (a tarefa de escoamento).
+
+#include "pico/stdlib.h"
+
+#define DIARIO_CAPACIDADE 128   // potência de 2
+#define DIARIO_PUBLICADO  0x8000
+
+// X(id, formato): {a} e {b} são os argumentos, no formato de str.format do
+// Python (ver tools/diario.py); horários vão como HHMM.
+// Novos eventos entram no fim para não mudar os ids já em campo.
+#define DIARIO_EVENTOS(X)                                               \
+    X(EV_BOTAO_APERTA,    "botão {a} apertado (tick {b})")              \
+    X(EV_BOTAO_SOLTA,     "botão {a} solto (tick {b})")                 \
+    X(EV_ESTADO,          "estado {a} -> {b}")                          \
+    X(EV_FASE_POMODORO,   "pomodoro fase={a} ciclo={b}")                \
+    X(EV_ALARME_ARMADO,   "alarme {a:04d} armado, toca em {b} s")       \
+    X(EV_ALARME_TOCA,     "alarme {a:04d} tocando")                     \
+    X(EV_PROTOCOLO,       "protocolo tipo=0x{a:02x} status={b}")
+
+#define DIARIO_ENUM(id, formato) id,
+typedef enum {
+    DIARIO_EVENTOS(DIARIO_ENUM)
+    DIARIO_NUM_EVENTOS
+} diario_evento_t;
+#undef DIARIO_ENUM
+
+// Registro como vai pela USB (little-endian; o layout natural já não tem
+// preenchimento, e o alinhamento mantém `seq` em uma escrita só)
+typedef struct {
+    uint32_t tempo_us;      // time_us_32() na reserva
+    uint16_t seq;           // DIARIO_PUBLICADO | índice (15 bits); 0 = sendo escrito
+    uint8_t evento;         // diario_evento_t
+    uint8_t nucleo;
+    uint32_t a;
+    uint32_t b;
+} diario_registro_t;
+
+void diario_inicia(void);
+
+// Pode ser chamada de qualquer contexto; nunca bloqueia por mais que a
+// reserva de outro produtor.
+void diario_registra(diario_evento_t evento, uint32_t a, uint32_t b);
+
+// Registros publicados ainda não lidos (aproximado se houver produtores ativos)
+uint diario_pendentes(void);
+
+// Copia até `max` registros prontos, em ordem. `perdidos` acumula os
+// registros sobrescritos antes de serem lidos.
+uint diario_retira(diario_registro_t *saida, uint max, uint32_t *perdidos);
+
+// Formato do evento (na flash) ou NULL se o id não existe
+const char *diario_formato(uint evento);
+
+#endif
@@ -0,0 +1,125 @@
+#include "efeitos_led.h"
+#include "hardware/pwm.h"
+#include "hardware/dma.h"
+
+// Vermelho, verde e azul em pinos seguidos ocupam 2 slices (11/12/13: 5B, 6A, 6B)
+#define EFEITOS_SLICES_MAX  2
+
+static uint16_t gama[256];
+
+static struct {
+    uint slice;
+    int8_t componente[2];          // por canal (A, B): 0/1/2 = r/g/b ou EFEITOS_SEM_LED
+    uint16_t fixo[2];              // nível dos canais sem LED
+    uint canal_dados;              // tabela -> CC, um passo por wrap
+    uint canal_controle;           // recarrega o endereço de leitura do canal de dados
+    const uint32_t *inicio;        // lido pelo canal de controle
+} slices[EFEITOS_SLICES_MAX];
+static uint num_slices = 0;
+
+// Uma tabela por slice: canal A nos 16 bits baixos, B nos altos (layout de CC)
+static uint32_t tabelas[EFEITOS_SLICES_MAX][EFEITOS_PASSOS];
+
+static int busca_slice(uint slice) {
+    for (uint i = 0; i < num_slices; i++) {
+        if (slices[i].slice == slice) return (int)i;
+    }
+    return -1;
+}
+
+static uint adiciona_slice(uint slice) {
+    int i = busca_slice(slice);
+    if (i >= 0) return (uint)i;
+    if (num_slices >= EFEITOS_SLICES_MAX) panic("efeitos_led: mais de %d slices", EFEITOS_SLICES_MAX);
+    slices[num_slices].slice = slice;
+    slices[num_slices].componente[0] = EFEITOS_SEM_LED;
+    slices[num_slices].componente[1] = EFEITOS_SEM_LED;
+    return num_slices++;
+}
+
+// Dados: EFEITOS_PASSOS palavras no ritmo do PWM e, no fim, encadeia o
+// controle (ou a si mesmo, que desliga o encadeamento)
+static void configura_dados(uint i, bool encadeia) {
+    dma_channel_config c = dma_channel_get_default_config(slices[i].canal_dados);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, pwm_get_dreq(slices[i].slice));
+    channel_config_set_chain_to(&c, encadeia ? slices[i].canal_controle : slices[i].canal_dados);
+    dma_channel_configure(slices[i].canal_dados, &c, &pwm_hw->slice[slices[i].slice].cc,
+                          tabelas[i], EFEITOS_PASSOS, false);
+}
+
+// Controle: uma palavra (o início da tabela) no READ_ADDR_TRIG dos dados
+static void configura_controle(uint i) {
+    dma_channel_config c = dma_channel_get_default_config(slices[i].canal_controle);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, false);
+    channel_config_set_write_increment(&c, false);
+    dma_channel_configure(slices[i].canal_controle, &c, &dma_hw->ch[slices[i].canal_dados].al3_read_addr_trig,
+                          &slices[i].inicio, 1, false);
+}
+
+void efeitos_led_inicia(uint pino_vermelho, uint pino_verde, uint pino_azul) {
+    const uint pinos[3] = {pino_vermelho, pino_verde, pino_azul};
+    efeitos_led_gera_gama(gama, 2.2f);
+
+    for (uint led = 0; led < 3; led++) {
+        gpio_set_function(pinos[led], GPIO_FUNC_PWM);
+        uint i = adiciona_slice(pwm_gpio_to_slice_num(pinos[led]));
+        slices[i].componente[pwm_gpio_to_channel(pinos[led])] = (int8_t)led;
+    }
+    for (uint i = 0; i < num_slices; i++) {
+        pwm_config config = pwm_get_default_config();
+        pwm_config_set_wrap(&config, EFEITOS_NIVEL_MAX);
+        pwm_config_set_clkdiv_int(&config, EFEITOS_PWM_DIV);
+        pwm_init(slices[i].slice, &config, true);
+        slices[i].canal_dados = (uint)dma_claim_unused_channel(true);
+        slices[i].canal_controle = (uint)dma_claim_unused_channel(true);
+        slices[i].inicio = tabelas[i];
+        configura_controle(i);
+    }
+    efeitos_led_apaga();
+}
+
+void efeitos_led_aplica(const efeito_led_t *efeito) {
+    for (uint i = 0; i < num_slices; i++) {
+        // Desencadeia antes do abort para o controle não redisparar os dados
+        configura_dados(i, false);
+        dma_channel_abort(slices[i].canal_controle);
+        dma_channel_abort(slices[i].canal_dados);
+    }
+
+    for (uint i = 0; i < num_slices; i++) {
+        efeitos_led_preenche_tabela(tabelas[i], efeito, gama, slices[i].componente, slices[i].fixo);
+        configura_dados(i, true);
+        dma_channel_start(slices[i].canal_dados);
+    }
+}
+
+void efeitos_led_canal_fixo(uint pino, uint16_t nivel) {
+    int i = busca_slice(pwm_gpio_to_slice_num(pino));
+    uint canal = pwm_gpio_to_channel(pino);
+    if (i < 0 || slices[i].componente[canal] != EFEITOS_SEM_LED) {
+        panic("efeitos_led: GPIO %u não é um canal livre de slice dos LEDs", pino);
+    }
+    slices[i].fixo[canal] = nivel;
+    // Só a metade do canal, na RAM (aqui a escrita de 16 bits não replica);
+    // o DMA pega o novo nível no próximo período de PWM
+    volatile uint16_t *metades = (volatile uint16_t *)tabelas[i];
+    for (uint passo = 0; passo < EFEITOS_PASSOS; passo++) metades[2 * passo + canal] = nivel;
+}
+
+void efeitos_led_fixo(cor_led_t cor) {
+    efeito_led_t e = {EFEITO_FIXO, cor, cor, 0};
+    efeitos_led_aplica(&e);
+}
+
+void efeitos_led_pisca(cor_led_t cor, uint8_t piscadas) {
+    efeito_led_t e = {EFEITO_PISCA, cor, cor, piscadas};
+    efeitos_led_aplica(&e);
+}
+
+void efeitos_led_apaga(void) {
+    efeitos_led_fixo(COR_APAGADA);
+}
@@ -0,0 +1,74 @@
+#ifndef EFEITOS_LED_H
+#define EFEITOS_LED_H
+
+// Efeitos no LED RGB sem trabalho da CPU.
+//
+// Cada efeito é pré-calculado (com correção de gama) em uma tabela com um
+// período de EFEITOS_PASSOS níveis por slice de PWM. Um canal de DMA por
+// slice, cadenciado pelo DREQ de wrap do PWM, copia um nível por período de
+// PWM para o registrador CC do slice; ao fim da tabela ele encadeia um canal
+// de controle que recarrega o endereço de leitura e o redispara, então o
+// efeito não termina nunca. A CPU só trabalha ao trocar de efeito.
+//
+// O DMA escreve o CC inteiro (os dois canais do slice): no RP2040 uma escrita
+// de 16 bits em registrador de periférico é replicada nas duas metades. Um
+// pino que divida o slice com um LED (o buzzer no GPIO10 divide o slice 5 com
+// o verde no GPIO11) tem o nível mantido na própria tabela por
+// efeitos_led_canal_fixo(), e não deve mexer no slice (wrap, divisor,
+// habilitação), que pertence a este módulo.
+
+#include "pico/stdlib.h"
+
+#define EFEITOS_PASSOS      1024   // níveis por período do efeito
+#define EFEITOS_NIVEL_MAX   1000   // TOP do PWM
+#define EFEITOS_PWM_DIV     250    // 125 MHz / 250 / 1001 ~= 500 Hz
+#define EFEITOS_PERIODO_MS  2048   // ~EFEITOS_PASSOS / 500 Hz
+#define EFEITOS_SEM_LED     (-1)   // canal do slice sem LED (nível fixo)
+
+typedef struct {
+    uint8_t r, g, b;
+} cor_led_t;
+
+typedef enum {
+    EFEITO_FIXO,        // cor constante
+    EFEITO_RESPIRA,     // cor sobe e desce suavemente
+    EFEITO_TRANSICAO,   // cor -> cor_final -> cor, suavemente
+    EFEITO_PISCA        // `piscadas` piscadas curtas e uma pausa
+} tipo_efeito_led_t;
+
+typedef struct {
+    tipo_efeito_led_t tipo;
+    cor_led_t cor;
+    cor_led_t cor_final;
+    uint8_t piscadas;
+} efeito_led_t;
+
+#define COR_APAGADA   ((cor_led_t){0, 0, 0})
+#define COR_VERMELHA  ((cor_led_t){255, 0, 0})
+#define COR_VERDE     ((cor_led_t){0, 255, 0})
+#define COR_AZUL      ((cor_led_t){0, 0, 255})
+
+void efeitos_led_inicia(uint pino_vermelho, uint pino_verde, uint pino_azul);
+void efeitos_led_aplica(const efeito_led_t *efeito);
+
+void efeitos_led_fixo(cor_led_t cor);
+void efeitos_led_pisca(cor_led_t cor, uint8_t piscadas);
+void efeitos_led_apaga(void);
+
+// Nível (0..EFEITOS_NIVEL_MAX) do outro canal de um slice usado pelos LEDs;
+// vale até a próxima chamada, inclusive depois de trocar de efeito. O pino
+// precisa estar em GPIO_FUNC_PWM.
+void efeitos_led_canal_fixo(uint pino, uint16_t nivel);
+
+// Funções puras usadas para montar as tabelas (inc/efeitos_led_tabela.c,
+// sem acesso a hardware)
+void efeitos_led_gera_gama(uint16_t gama[256], float expoente);
+cor_led_t efeitos_led_cor_no_passo(const efeito_led_t *efeito, uint passo);
+
+// Tabela de um slice no layout de CC (canal A nos 16 bits baixos, B nos
+// altos). componente[canal] = 0/1/2 (r/g/b) para um LED ou EFEITOS_SEM_LED,
+// e aí o canal fica em fixo[canal].
+void efeitos_led_preenche_tabela(uint32_t tabela[EFEITOS_PASSOS], const efeito_led_t *efeito,
+                                 const uint16_t gama[256], const int8_t componente[2], const uint16_t fixo[2]);
+
+#endif
@@ -0,0 +1,54 @@
+#include <math.h>
+#include "efeitos_led.h"
+
+#define PASSOS_POR_PISCADA  64     // ~128 ms aceso, ~128 ms apagado
+
+void efeitos_led_gera_gama(uint16_t tabela[256], float expoente) {
+    for (uint i = 0; i < 256; i++) {
+        tabela[i] = (uint16_t)(powf(i / 255.0f, expoente) * EFEITOS_NIVEL_MAX + 0.5f);
+    }
+}
+
+// Sobe e desce suave (smoothstep de um triângulo), 0..255 ao longo do período
+static uint8_t onda_suave(uint passo) {
+    uint32_t tri = (passo < EFEITOS_PASSOS / 2) ? passo * 2 : (EFEITOS_PASSOS - 1 - passo) * 2;
+    uint64_t n = EFEITOS_PASSOS - 2;   // pico do triângulo
+    return (uint8_t)((uint64_t)tri * tri * (3 * n - 2 * tri) * 255 / (n * n * n));
+}
+
+static uint8_t mistura(uint8_t de, uint8_t para, uint8_t fator) {
+    return (uint8_t)(de + ((int)para - (int)de) * fator / 255);
+}
+
+cor_led_t efeitos_led_cor_no_passo(const efeito_led_t *efeito, uint passo) {
+    cor_led_t c = efeito->cor;
+    if (efeito->tipo == EFEITO_RESPIRA) {
+        uint8_t f = onda_suave(passo);
+        c.r = c.r * f / 255;
+        c.g = c.g * f / 255;
+        c.b = c.b * f / 255;
+    } else if (efeito->tipo == EFEITO_TRANSICAO) {
+        uint8_t f = onda_suave(passo);
+        c.r = mistura(efeito->cor.r, efeito->cor_final.r, f);
+        c.g = mistura(efeito->cor.g, efeito->cor_final.g, f);
+        c.b = mistura(efeito->cor.b, efeito->cor_final.b, f);
+    } else if (efeito->tipo == EFEITO_PISCA) {
+        uint slot = passo / PASSOS_POR_PISCADA;
+        if (slot % 2 != 0 || slot / 2 >= efeito->piscadas) c = COR_APAGADA;
+    }
+    return c;
+}
+
+void efeitos_led_preenche_tabela(uint32_t tabela[EFEITOS_PASSOS], const efeito_led_t *efeito,
+                                 const uint16_t gama[256], const int8_t componente[2], const uint16_t fixo[2]) {
+    for (uint passo = 0; passo < EFEITOS_PASSOS; passo++) {
+        cor_led_t c = efeitos_led_cor_no_passo(efeito, passo);
+        const uint8_t componentes[3] = {c.r, c.g, c.b};
+        uint32_t palavra = 0;
+        for (uint canal = 0; canal < 2; canal++) {
+            uint16_t nivel = componente[canal] == EFEITOS_SEM_LED ? fixo[canal] : gama[componentes[componente[canal]]];
+            palavra |= (uint32_t)nivel << (16 * canal);
+        }
+        tabela[passo] = palavra;
+    }
+}
@@ -0,0 +1,55 @@
+#include "horario.h"
+
+// Passo imediato, repetição após 350 ms a cada 180 ms, acelerando até 35 ms
+// em 1,5 s. O limiar acompanha o de le_joystick (1000 de 2048).
+const repeticao_config_t repeticao_edicao = {
+    .deflexao_minima = 49,
+    .atraso_inicial_ms = 350,
+    .intervalo_lento_ms = 180,
+    .intervalo_rapido_ms = 35,
+    .tempo_aceleracao_ms = 1500,
+    .max_passos = 3,
+};
+
+void ajusta_digito(Horario *horario, int indice, int passo) {
+    if (indice == 0) {
+        int dezena = (horario->horas / 10 + passo + 3) % 3;
+        int unidade = horario->horas % 10;
+        if (dezena == 2 && unidade > 3) unidade = 3;
+        horario->horas = dezena * 10 + unidade;
+    } else if (indice == 1) {
+        int dezena = horario->horas / 10;
+        int max = (dezena == 2) ? 3 : 9;
+        int unidade = (horario->horas % 10 + passo + max + 1) % (max + 1);
+        horario->horas = dezena * 10 + unidade;
+    } else if (indice == 2) {
+        int dezena = (horario->minutos / 10 + passo + 6) % 6;
+        horario->minutos = dezena * 10 + horario->minutos % 10;
+    } else if (indice == 3) {
+        int unidade = (horario->minutos % 10 + passo + 10) % 10;
+        horario->minutos = (horario->minutos / 10) * 10 + unidade;
+    }
+}
+
+void ajusta_campo(Horario *horario, int alvo, int passo) {
+    if (alvo == ALVO_HORAS) {
+        horario->horas = ((horario->horas + passo) % 24 + 24) % 24;
+    } else {
+        horario->minutos = ((horario->minutos + passo) % 60 + 60) % 60;
+    }
+}
+
+void ajusta_alvo(Horario *horario, int alvo, int passos) {
+    if (alvo < ALVO_DIGITO) {
+        ajusta_campo(horario, alvo, passos);
+        return;
+    }
+    int passo = (passos > 0) ? 1 : -1;
+    for (int i = 0; i != passos; i += passo) {
+        ajusta_digito(horario, alvo - ALVO_DIGITO, passo);
+    }
+}
+
+int move_alvo(int alvo, int sentido) {
+    return (alvo + sentido + NUM_ALVOS) % NUM_ALVOS;
+}
@@ -0,0 +1,39 @@
+#ifndef HORARIO_H
+#define HORARIO_H
+
+// Horário HH:MM e os passos do editor de horário.
+//
+// O cursor do editor percorre seis alvos: os campos inteiros de horas e
+// minutos (passos com volta, 23 -> 00) e depois os quatro dígitos de HH:MM
+// (cada um dentro da sua faixa). Os passos vêm de repeticao_atualiza().
+//
+// Módulo puro (sem hardware), exercitado no host em test/test_repeticao.c.
+
+#include "repeticao.h"
+
+typedef struct {
+    int horas;
+    int minutos;
+} Horario;
+
+#define ALVO_HORAS    0
+#define ALVO_MINUTOS  1
+#define ALVO_DIGITO   2   // ALVO_DIGITO + 0..3 = dígitos de HH:MM
+#define NUM_ALVOS     6
+
+// Curva de auto-repetição do editor (esquerda/direita no joystick)
+extern const repeticao_config_t repeticao_edicao;
+
+// Altera um dígito de HH:MM (0 = dezena da hora ... 3 = unidade do minuto)
+void ajusta_digito(Horario *horario, int indice, int passo);
+
+// Passo em um campo inteiro (ALVO_HORAS ou ALVO_MINUTOS), com volta
+void ajusta_campo(Horario *horario, int alvo, int passo);
+
+// Aplica `passos` (com sinal) ao alvo do cursor
+void ajusta_alvo(Horario *horario, int alvo, int passos);
+
+// Próximo alvo ao mover o cursor (sentido -1 ou +1), com volta
+int move_alvo(int alvo, int sentido);
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef ICONES_H
+#define ICONES_H
+
+#include <stdint.h>
+
+// Icones 16x16 no formato nativo do display: coluna a coluna, cada coluna
+// com 2 bytes (pagina 0 e pagina 1), bit 0 = linha de cima da pagina.
+// Usar com ssd1306_blit(&display, icone, NULL, ICONE_LARGURA, ICONE_ALTURA, x, y, op).
+
+#define ICONE_LARGURA 16
+#define ICONE_ALTURA  16
+
+static const uint8_t icone_sino[] = {
+    0x00, 0x18, 0x00, 0x1c, 0xe0, 0x1f, 0xf8, 0x1f,
+    0xfc, 0x1f, 0xfc, 0x1f, 0xfe, 0x5f, 0xff, 0xdf,
+    0xff, 0xdf, 0xfe, 0x5f, 0xfc, 0x1f, 0xfc, 0x1f,
+    0xf8, 0x1f, 0xe0, 0x1f, 0x00, 0x1c, 0x00, 0x18,
+};
+
+static const uint8_t icone_cafe[] = {
+    0xe0, 0x4f, 0xe0, 0xdf, 0xe0, 0xff, 0xea, 0xff,
+    0xe5, 0xff, 0xe0, 0xff, 0xea, 0xff, 0xe5, 0xff,
+    0xe0, 0xff, 0xea, 0xff, 0xe5, 0xdf, 0xe0, 0xc7,
+    0x00, 0xc0, 0x40, 0xc4, 0xc0, 0xc7, 0x00, 0x40,
+};
+
+static const uint8_t icone_livro[] = {
+    0xfc, 0x0f, 0x02, 0x10, 0xaa, 0x12, 0xaa, 0x12,
+    0xaa, 0x12, 0xaa, 0x12, 0x02, 0x10, 0xfc, 0x2f,
+    0xfc, 0x2f, 0x02, 0x10, 0xaa, 0x12, 0xaa, 0x12,
+    0xaa, 0x12, 0xaa, 0x12, 0x02, 0x10, 0xfc, 0x0f,
+};
+
+#endif
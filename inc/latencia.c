@@ -0,0 +1,149 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "latencia.h"
+#include "hardware/sync.h"
+
+#ifdef LATENCIA_HABILITADA
+
+#define LAT_CAPACIDADE 1024   // potência de 2
+
+static lat_registro_t registros[LAT_CAPACIDADE];
+static uint32_t escrita = 0;      // total de registros já escritos
+static uint32_t lidos = 0;        // total de registros já despejados
+static uint32_t perdidos = 0;
+static volatile uint8_t tela_atual = 0;
+static uint8_t ultima_direcao = 0xFF;
+static uint16_t ultimo_x = 0, ultimo_y = 0;
+
+// Variação do ADC que gera um novo registro mesmo sem trocar de direção:
+// 5% do curso (a deflexão em % vem de (valor - 2048) / 2048). Sem isso o
+// replay seguraria a primeira amostra e a aceleração da edição mudaria.
+#define LAT_PASSO_JOYSTICK (2048 * 5 / 100)
+
+static void registra(uint8_t tipo, uint32_t tempo_us, uint8_t detalhe, uint16_t a, uint16_t b) {
+    uint32_t estado = save_and_disable_interrupts();
+    lat_registro_t *r = &registros[escrita & (LAT_CAPACIDADE - 1)];
+    r->tempo_us = tempo_us;
+    r->tipo = tipo;
+    r->tela = tela_atual;
+    r->detalhe = detalhe;
+    r->a = a;
+    r->b = b;
+    escrita++;
+    restore_interrupts(estado);
+}
+
+#ifdef LATENCIA_REPLAY
+#include LATENCIA_TRACE_ARQUIVO   // define trace_replay[]
+
+static gpio_irq_callback_t callback_replay = NULL;
+static size_t proximo_botao = 0;
+static size_t proximo_joystick = 0;
+static uint16_t joystick_x = 2048, joystick_y = 2048;
+static volatile bool injetando = false;
+
+static size_t avanca(size_t i, uint8_t tipo) {
+    while (i < count_of(trace_replay) && trace_replay[i].tipo != tipo) i++;
+    return i;
+}
+
+// Injeta as bordas de botão do trace no mesmo contexto de IRQ do hardware
+static int64_t injeta_botoes(alarm_id_t id, void *dados) {
+    (void)id; (void)dados;
+    uint32_t agora = time_us_32();
+    while (proximo_botao < count_of(trace_replay) &&
+           (int32_t)(agora - trace_replay[proximo_botao].tempo_us) >= 0) {
+        injetando = true;
+        callback_replay(trace_replay[proximo_botao].a, GPIO_IRQ_EDGE_FALL);
+        injetando = false;
+        proximo_botao = avanca(proximo_botao + 1, LAT_BOTAO);
+    }
+    if (proximo_botao >= count_of(trace_replay)) return 0;
+    return -(int64_t)(int32_t)(trace_replay[proximo_botao].tempo_us - agora);
+}
+
+void latencia_inicia(gpio_irq_callback_t callback_botoes) {
+    callback_replay = callback_botoes;
+    proximo_botao = avanca(0, LAT_BOTAO);
+    proximo_joystick = avanca(0, LAT_JOYSTICK);
+    if (proximo_botao < count_of(trace_replay))
+        add_alarm_at(from_us_since_boot(trace_replay[proximo_botao].tempo_us), injeta_botoes, NULL, true);
+}
+
+void latencia_reproduz_joystick(uint16_t *x, uint16_t *y) {
+    uint32_t agora = time_us_32();
+    while (proximo_joystick < count_of(trace_replay) &&
+           (int32_t)(agora - trace_replay[proximo_joystick].tempo_us) >= 0) {
+        joystick_x = trace_replay[proximo_joystick].a;
+        joystick_y = trace_replay[proximo_joystick].b;
+        proximo_joystick = avanca(proximo_joystick + 1, LAT_JOYSTICK);
+    }
+    *x = joystick_x;
+    *y = joystick_y;
+}
+
+bool latencia_botao(uint gpio) {
+    if (!injetando) return false;   // botões reais são ignorados no replay
+    registra(LAT_BOTAO, time_us_32(), 0, gpio, 0);
+    return true;
+}
+
+#else
+
+void latencia_inicia(gpio_irq_callback_t callback_botoes) {
+    (void)callback_botoes;
+}
+
+void latencia_reproduz_joystick(uint16_t *x, uint16_t *y) {
+    (void)x; (void)y;
+}
+
+bool latencia_botao(uint gpio) {
+    registra(LAT_BOTAO, time_us_32(), 0, gpio, 0);
+    return true;
+}
+
+#endif
+
+void latencia_define_tela(uint8_t tela) {
+    tela_atual = tela;
+}
+
+void latencia_joystick(uint16_t x, uint16_t y, uint8_t direcao) {
+    if (direcao == ultima_direcao &&
+        abs((int)x - ultimo_x) < LAT_PASSO_JOYSTICK && abs((int)y - ultimo_y) < LAT_PASSO_JOYSTICK)
+        return;
+    ultima_direcao = direcao;
+    ultimo_x = x;
+    ultimo_y = y;
+    registra(LAT_JOYSTICK, time_us_32(), direcao, x, y);
+}
+
+void latencia_quadro(uint32_t inicio_us, uint32_t fim_us) {
+    uint32_t duracao = fim_us - inicio_us;
+    registra(LAT_QUADRO, fim_us, 0, duracao > 0xFFFF ? 0xFFFF : duracao, 0);
+}
+
+void latencia_atende_entrada(void) {
+    registra(LAT_ATENDE, time_us_32(), 0, 0, 0);
+}
+
+// Envia os registros pendentes pela stdio. Bloqueia enquanto imprime, então
+// deve ser chamada fora das telas medidas (ex.: ao voltar ao menu).
+void latencia_despeja(void) {
+    uint32_t estado = save_and_disable_interrupts();
+    uint32_t fim = escrita;
+    if (fim - lidos > LAT_CAPACIDADE) {
+        perdidos += fim - lidos - LAT_CAPACIDADE;
+        lidos = fim - LAT_CAPACIDADE;
+    }
+    restore_interrupts(estado);
+
+    for (; lidos != fim; lidos++) {
+        const lat_registro_t *r = &registros[lidos & (LAT_CAPACIDADE - 1)];
+        printf("LAT,%lu,%u,%u,%u,%u,%u\n", (unsigned long)r->tempo_us, r->tipo, r->tela, r->detalhe, r->a, r->b);
+    }
+    printf("LAT_PERDIDOS,%lu\n", (unsigned long)perdidos);
+}
+
+#endif
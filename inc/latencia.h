@@ -0,0 +1,68 @@
+#ifndef LATENCIA_H
+#define LATENCIA_H
+
+// Medição de latência entrada -> pixel.
+//
+// Com LATENCIA_HABILITADA, cada mudança de direção ou variação de 5% da
+// deflexão do joystick, cada borda de botão e cada quadro entregue ao
+// barramento viram um registro com carimbo de tempo em um buffer circular. latencia_despeja() envia os registros pela
+// stdio em linhas "LAT,..." que tools/latencia.py transforma na distribuição
+// de latência por tela. A aplicação chama latencia_atende_entrada() quando
+// age sobre uma entrada; só os quadros precedidos por essa marca contam como
+// resposta, então os redesenhos por tempo (contagens de 1 Hz) não fecham
+// entradas pendentes.
+//
+// Com LATENCIA_REPLAY, as entradas reais são ignoradas e o trace em
+// LATENCIA_TRACE_ARQUIVO (gerado por tools/latencia.py) é reproduzido nos
+// mesmos instantes, permitindo comparar versões com a mesma entrada.
+// Limitação: o replay roda na própria placa, com os botões injetados por
+// add_alarm_at e o joystick lido do trace a cada amostragem. Não existe um
+// build determinístico no host; a repetição só é tão exata quanto o timer e
+// a latência das interrupções, então compare distribuições, não quadros.
+//
+// Sem LATENCIA_HABILITADA todas as funções são vazias.
+
+#include "pico/stdlib.h"
+#include "hardware/gpio.h"
+
+typedef enum {
+    LAT_JOYSTICK,   // a = x, b = y (ADC cru), detalhe = direção resultante
+    LAT_BOTAO,      // a = gpio
+    LAT_QUADRO,     // quadro enviado; tempo = fim do envio, a = duração em us
+    LAT_ATENDE      // a aplicação agiu sobre uma entrada
+} lat_tipo_t;
+
+typedef struct {
+    uint32_t tempo_us;
+    uint8_t tipo;
+    uint8_t tela;
+    uint8_t detalhe;
+    uint16_t a;
+    uint16_t b;
+} lat_registro_t;
+
+#ifdef LATENCIA_HABILITADA
+
+void latencia_inicia(gpio_irq_callback_t callback_botoes);
+void latencia_define_tela(uint8_t tela);
+void latencia_reproduz_joystick(uint16_t *x, uint16_t *y);
+void latencia_joystick(uint16_t x, uint16_t y, uint8_t direcao);
+bool latencia_botao(uint gpio);
+void latencia_quadro(uint32_t inicio_us, uint32_t fim_us);
+void latencia_atende_entrada(void);
+void latencia_despeja(void);
+
+#else
+
+static inline void latencia_inicia(gpio_irq_callback_t callback_botoes) { (void)callback_botoes; }
+static inline void latencia_define_tela(uint8_t tela) { (void)tela; }
+static inline void latencia_reproduz_joystick(uint16_t *x, uint16_t *y) { (void)x; (void)y; }
+static inline void latencia_joystick(uint16_t x, uint16_t y, uint8_t direcao) { (void)x; (void)y; (void)direcao; }
+static inline bool latencia_botao(uint gpio) { (void)gpio; return true; }
+static inline void latencia_quadro(uint32_t inicio_us, uint32_t fim_us) { (void)inicio_us; (void)fim_us; }
+static inline void latencia_atende_entrada(void) {}
+static inline void latencia_despeja(void) {}
+
+#endif
+
+#endif
@@ -0,0 +1,103 @@
+#include "pomodoro.h"
+
+// Próxima fase com e sem avanço automático. Regras fora da tabela: a pausa
+// do último ciclo do bloco vira pausa longa, e sair de uma pausa conta um
+// ciclo (encerrando a sessão no fim do último bloco).
+static const struct {
+    bool contagem;
+    FasePomodoro proxima;
+    FasePomodoro proxima_automatica;
+} transicoes[NUM_FASES] = {
+    [FASE_ESTUDO]         = {true,  FASE_AGUARDA_PAUSA,  FASE_PAUSA},
+    [FASE_AGUARDA_PAUSA]  = {false, FASE_PAUSA,          FASE_PAUSA},
+    [FASE_PAUSA]          = {true,  FASE_AGUARDA_ESTUDO, FASE_ESTUDO},
+    [FASE_AGUARDA_ESTUDO] = {false, FASE_ESTUDO,         FASE_ESTUDO},
+    [FASE_PAUSA_LONGA]    = {true,  FASE_AGUARDA_ESTUDO, FASE_ESTUDO},
+    [FASE_CONCLUIDO]      = {false, FASE_CONCLUIDO,      FASE_CONCLUIDO},
+};
+
+static uint32_t duracao_min(const cronograma_t *c, FasePomodoro fase) {
+    if (fase == FASE_ESTUDO) return c->estudo_min;
+    if (fase == FASE_PAUSA) return c->pausa_min;
+    if (fase == FASE_PAUSA_LONGA) return c->pausa_longa_min;
+    return 0;
+}
+
+static void entra(pomodoro_t *p, FasePomodoro fase, uint64_t inicio_us) {
+    p->fase = fase;
+    p->inicio_us = inicio_us;
+    p->fim_us = transicoes[fase].contagem
+                    ? inicio_us + (uint64_t)duracao_min(&p->cronograma, fase) * 60 * 1000000
+                    : POMODORO_SEM_FIM;
+}
+
+bool pomodoro_pausa_longa_a_seguir(const pomodoro_t *p) {
+    return p->cronograma.pausa_longa_min > 0 && p->ciclo + 1 >= p->cronograma.ciclos;
+}
+
+static void avanca(pomodoro_t *p, uint64_t instante_us) {
+    const cronograma_t *c = &p->cronograma;
+    FasePomodoro atual = p->fase;
+    FasePomodoro proxima = c->avanco_automatico ? transicoes[atual].proxima_automatica
+                                                : transicoes[atual].proxima;
+
+    if (proxima == FASE_PAUSA && pomodoro_pausa_longa_a_seguir(p)) proxima = FASE_PAUSA_LONGA;
+
+    if (atual == FASE_PAUSA || atual == FASE_PAUSA_LONGA) {
+        if (++p->ciclo >= c->ciclos) {
+            p->ciclo = 0;
+            p->bloco++;
+            if (c->blocos && p->bloco >= c->blocos) proxima = FASE_CONCLUIDO;
+        }
+    }
+    entra(p, proxima, instante_us);
+}
+
+void pomodoro_inicia(pomodoro_t *p, const cronograma_t *cronograma, uint64_t agora_us) {
+    p->cronograma = *cronograma;
+    if (p->cronograma.ciclos == 0) p->cronograma.ciclos = 1;
+    p->ciclo = 0;
+    p->bloco = 0;
+    entra(p, FASE_ESTUDO, agora_us);
+}
+
+bool pomodoro_atualiza(pomodoro_t *p, uint64_t agora_us) {
+    bool mudou = false;
+    // Encadeia pelo fim_us anterior: sem deriva, mesmo com atrasos
+    while (transicoes[p->fase].contagem && agora_us >= p->fim_us) {
+        avanca(p, p->fim_us);
+        mudou = true;
+    }
+    return mudou;
+}
+
+bool pomodoro_confirma(pomodoro_t *p, uint64_t agora_us) {
+    if (!pomodoro_aguardando(p)) return false;
+    avanca(p, agora_us);
+    return true;
+}
+
+bool pomodoro_fase_com_contagem(FasePomodoro fase) {
+    return transicoes[fase].contagem;
+}
+
+bool pomodoro_aguardando(const pomodoro_t *p) {
+    return !transicoes[p->fase].contagem && p->fase != FASE_CONCLUIDO;
+}
+
+uint32_t pomodoro_restante_s(const pomodoro_t *p, uint64_t agora_us) {
+    if (!transicoes[p->fase].contagem || agora_us >= p->fim_us) return 0;
+    return (uint32_t)((p->fim_us - agora_us + 999999) / 1000000);
+}
+
+uint32_t pomodoro_duracao_fase_s(const pomodoro_t *p) {
+    return duracao_min(&p->cronograma, p->fase) * 60;
+}
+
+uint32_t pomodoro_duracao_sessao_s(const cronograma_t *c) {
+    if (c->blocos == 0) return 0;
+    uint32_t ciclos = c->ciclos ? c->ciclos : 1;
+    uint32_t pausa_final = c->pausa_longa_min ? c->pausa_longa_min : c->pausa_min;
+    uint32_t bloco_min = ciclos * c->estudo_min + (ciclos - 1) * c->pausa_min + pausa_final;
+    return c->blocos * bloco_min * 60;
+}
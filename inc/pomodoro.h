@@ -0,0 +1,69 @@
+#ifndef POMODORO_H
+#define POMODORO_H
+
+// Máquina de estados do pomodoro dirigida por tabela.
+//
+// Um cronograma descreve a sessão: blocos de `ciclos` estudos separados por
+// pausas, com a última pausa do bloco trocada pela pausa longa (ex.: 4 x
+// (25 estudo, 5 pausa) e 20 de pausa longa). Sem avanço automático, cada
+// fim de contagem passa por uma fase de espera que só avança com
+// pomodoro_confirma().
+//
+// Módulo puro: todo instante vem do chamador (time_us_64() no firmware, um
+// relógio virtual no host), então um dia inteiro de cronogramas pode ser
+// simulado em milissegundos. Nada aqui bloqueia.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define POMODORO_SEM_FIM UINT64_MAX
+
+typedef enum {
+    FASE_ESTUDO,
+    FASE_AGUARDA_PAUSA,
+    FASE_PAUSA,
+    FASE_AGUARDA_ESTUDO,
+    FASE_PAUSA_LONGA,
+    FASE_CONCLUIDO,
+    NUM_FASES
+} FasePomodoro;
+
+typedef struct {
+    uint8_t estudo_min;
+    uint8_t pausa_min;
+    uint8_t ciclos;             // estudos por bloco (>= 1)
+    uint8_t pausa_longa_min;    // no fim do bloco; 0 = pausa normal
+    uint8_t blocos;             // blocos na sessão; 0 = até parar
+    bool avanco_automatico;     // pula as fases de espera
+} cronograma_t;
+
+typedef struct {
+    cronograma_t cronograma;
+    FasePomodoro fase;
+    uint8_t ciclo;              // estudo atual dentro do bloco (0..ciclos-1)
+    uint8_t bloco;
+    uint64_t inicio_us;
+    uint64_t fim_us;            // POMODORO_SEM_FIM nas fases sem contagem
+} pomodoro_t;
+
+void pomodoro_inicia(pomodoro_t *p, const cronograma_t *cronograma, uint64_t agora_us);
+
+// Aplica todas as transições por tempo até `agora_us`; true se a fase mudou
+bool pomodoro_atualiza(pomodoro_t *p, uint64_t agora_us);
+
+// Confirmação do usuário numa fase de espera; true se avançou
+bool pomodoro_confirma(pomodoro_t *p, uint64_t agora_us);
+
+bool pomodoro_fase_com_contagem(FasePomodoro fase);
+bool pomodoro_aguardando(const pomodoro_t *p);
+
+// A pausa que vem depois do estudo atual é a longa?
+bool pomodoro_pausa_longa_a_seguir(const pomodoro_t *p);
+
+uint32_t pomodoro_restante_s(const pomodoro_t *p, uint64_t agora_us);
+uint32_t pomodoro_duracao_fase_s(const pomodoro_t *p);
+
+// Tempo total de contagem da sessão (sem as esperas); 0 se não tem fim
+uint32_t pomodoro_duracao_sessao_s(const cronograma_t *cronograma);
+
+#endif
@@ -0,0 +1,103 @@
+#include <string.h>
+#include "protocolo.h"
+
+uint16_t protocolo_crc16(const uint8_t *dados, size_t tamanho) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < tamanho; i++) {
+        crc ^= (uint16_t)dados[i] << 8;
+        for (int b = 0; b < 8; b++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+void protocolo_rx_inicia(protocolo_rx_t *rx) {
+    memset(rx, 0, sizeof(*rx));
+}
+
+static void remove_inicio(protocolo_rx_t *rx, uint16_t n) {
+    memmove(rx->buffer, rx->buffer + n, rx->usados - n);
+    rx->usados -= n;
+    rx->velhos = rx->velhos > n ? rx->velhos - n : 0;
+}
+
+// Tudo o que está no buffer chegou antes de uma pausa maior que o timeout
+static void marca_velhos(protocolo_rx_t *rx, uint32_t agora_ms) {
+    if ((uint32_t)(agora_ms - rx->ultimo_ms) > PROTO_TIMEOUT_MS) rx->velhos = rx->usados;
+}
+
+static void entrega_pendente(protocolo_rx_t *rx) {
+    if (rx->consumir) {
+        remove_inicio(rx, rx->consumir);
+        rx->consumir = 0;
+    }
+}
+
+void protocolo_recebe(protocolo_rx_t *rx, uint8_t byte, uint32_t agora_ms) {
+    entrega_pendente(rx);
+    // Só acontece se protocolo_proximo não foi chamada: abre espaço
+    if (rx->usados == PROTO_MAX_QUADRO) {
+        remove_inicio(rx, 1);
+        rx->descartados++;
+    }
+    marca_velhos(rx, agora_ms);
+    rx->buffer[rx->usados++] = byte;
+    rx->ultimo_ms = agora_ms;
+}
+
+bool protocolo_proximo(protocolo_rx_t *rx, uint32_t agora_ms, protocolo_msg_t *msg) {
+    entrega_pendente(rx);
+    marca_velhos(rx, agora_ms);
+
+    // Ressincroniza descartando um byte por vez até o buffer começar com um
+    // cabeçalho plausível; um CRC errado ou um quadro parcial que começou
+    // antes de uma pausa maior que o timeout descarta só o primeiro sync, e o
+    // resto é examinado de novo.
+    while (rx->usados > 0) {
+        bool invalido = rx->buffer[0] != PROTO_SYNC0 ||
+                        (rx->usados > 1 && rx->buffer[1] != PROTO_SYNC1) ||
+                        (rx->usados > 2 && rx->buffer[2] > PROTO_MAX_DADOS);
+        if (invalido) {
+            remove_inicio(rx, 1);
+            rx->descartados++;
+            continue;
+        }
+
+        uint16_t total = rx->usados < PROTO_CABECALHO ? PROTO_MAX_QUADRO : PROTO_CABECALHO + rx->buffer[2] + 2;
+        if (rx->usados < total) {
+            if (rx->velhos == 0) return false;
+            rx->expirados++;
+            remove_inicio(rx, 1);
+            continue;
+        }
+
+        uint16_t crc = rx->buffer[total - 2] | (uint16_t)rx->buffer[total - 1] << 8;
+        if (crc != protocolo_crc16(&rx->buffer[2], total - 4)) {
+            rx->erros_crc++;
+            remove_inicio(rx, 1);
+            continue;
+        }
+
+        msg->tipo = rx->buffer[3];
+        msg->tamanho = rx->buffer[2];
+        msg->dados = &rx->buffer[PROTO_CABECALHO];
+        rx->consumir = total;
+        rx->quadros++;
+        return true;
+    }
+    return false;
+}
+
+size_t protocolo_monta(uint8_t *saida, uint8_t tipo, const void *dados, uint8_t tamanho) {
+    if (tamanho > PROTO_MAX_DADOS) tamanho = PROTO_MAX_DADOS;
+    saida[0] = PROTO_SYNC0;
+    saida[1] = PROTO_SYNC1;
+    saida[2] = tamanho;
+    saida[3] = tipo;
+    if (tamanho) memcpy(&saida[PROTO_CABECALHO], dados, tamanho);
+    uint16_t crc = protocolo_crc16(&saida[2], tamanho + 2);
+    saida[PROTO_CABECALHO + tamanho] = crc & 0xFF;
+    saida[PROTO_CABECALHO + tamanho + 1] = crc >> 8;
+    return PROTO_CABECALHO + tamanho + 2;
+}
@@ -0,0 +1,112 @@
+#ifndef PROTOCOLO_H
+#define PROTOCOLO_H
+
+// Protocolo binário sobre a stdio USB CDC.
+//
+// Quadro: A5 5A | tamanho | tipo | dados[tamanho] | crc16 (LE)
+// O CRC-16/CCITT-FALSE (poli 0x1021, início 0xFFFF) cobre tamanho, tipo e
+// dados. Bytes fora de quadro (ex.: texto de printf) são descartados até o
+// próximo A5 5A, então protocolo e texto convivem na mesma porta.
+//
+// Comandos (host -> placa); a resposta tem o tipo | PROTO_RESPOSTA:
+//   PROTO_RELOGIO   [hh, mm, ss]                   acerta o relógio
+//   PROTO_ALARMES   [n, (hh, mm) * n]              substitui a lista (n = 0 limpa);
+//                   na placa, o editor só acrescenta um alarme e o B na
+//                   contagem cancela só o mostrado, o resto da lista fica
+//   PROTO_PRESETS   [n, preset * n]                presets do pomodoro (n = 0 volta ao padrão)
+//                   preset = estudo, pausa, ciclos, pausa_longa, blocos, opções
+//                   (minutos; pausa_longa 0 = sem; blocos 0 = sem fim;
+//                   opções: PROTO_PRESET_AUTOMATICO = avanço automático)
+//   PROTO_CONSULTA  []                             estado atual (ver protocolo_estado_t)
+//   PROTO_FORMATO   [id]                           formato do evento `id` do diário;
+//                   resposta [num_eventos, id, texto] ou só [num_eventos]
+//                   se o id não existe
+// Comandos de configuração respondem [status] (PROTO_OK / PROTO_INVALIDO).
+//
+// Sem pedido (placa -> host):
+//   PROTO_DIARIO    [perdidos (u32), diario_registro_t * n]   ver inc/diario.h
+//
+// Módulo puro: o parser recebe um byte por vez e devolve as mensagens
+// apontando para dentro do próprio buffer de recepção, sem cópia. Um quadro
+// parcial parado há mais de PROTO_TIMEOUT_MS é abandonado (só o sync dele
+// sai, então um quadro completo que estivesse dentro ainda é entregue).
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define PROTO_SYNC0         0xA5
+#define PROTO_SYNC1         0x5A
+#define PROTO_MAX_DADOS     120
+#define PROTO_CABECALHO     4     // sync0, sync1, tamanho, tipo
+#define PROTO_MAX_QUADRO    (PROTO_CABECALHO + PROTO_MAX_DADOS + 2)
+#define PROTO_TIMEOUT_MS    200   // máximo entre bytes de um quadro
+
+typedef enum {
+    PROTO_RELOGIO  = 0x01,
+    PROTO_ALARMES  = 0x02,
+    PROTO_PRESETS  = 0x03,
+    PROTO_CONSULTA = 0x04,
+    PROTO_DIARIO   = 0x05,
+    PROTO_FORMATO  = 0x06,
+    PROTO_RESPOSTA = 0x80
+} protocolo_tipo_t;
+
+#define PROTO_PRESET_BYTES       6
+#define PROTO_PRESET_AUTOMATICO  0x01
+
+typedef enum {
+    PROTO_OK = 0,
+    PROTO_INVALIDO = 1,
+    PROTO_DESCONHECIDO = 2
+} protocolo_status_t;
+
+// Resposta de PROTO_CONSULTA (little-endian, sem preenchimento)
+typedef struct __attribute__((packed)) {
+    uint8_t estado;             // EstadoAplicacao
+    uint8_t horas, minutos, segundos;
+    uint8_t alarme_armado;
+    uint8_t num_alarmes;
+    uint32_t alarme_restante_s;
+    uint8_t pomodoro_ativo;
+    uint8_t fase_pomodoro;      // FasePomodoro
+    uint8_t ciclo_pomodoro;
+    uint32_t fase_restante_s;
+    uint8_t num_presets;
+    uint8_t preset_selecionado;
+} protocolo_estado_t;
+
+typedef struct {
+    uint8_t tipo;
+    uint8_t tamanho;
+    const uint8_t *dados;       // válido até a próxima chamada do parser
+} protocolo_msg_t;
+
+typedef struct {
+    uint8_t buffer[PROTO_MAX_QUADRO];
+    uint16_t usados;
+    uint16_t consumir;          // quadro entregue na chamada anterior
+    uint16_t velhos;            // bytes do início chegados antes de uma pausa > timeout
+    uint32_t ultimo_ms;         // chegada do último byte
+    uint32_t quadros;
+    uint32_t erros_crc;
+    uint32_t descartados;
+    uint32_t expirados;         // quadros parciais abandonados
+} protocolo_rx_t;
+
+uint16_t protocolo_crc16(const uint8_t *dados, size_t tamanho);
+
+void protocolo_rx_inicia(protocolo_rx_t *rx);
+
+// Guarda um byte chegado em `agora_ms`. Depois de cada byte, chame
+// protocolo_proximo() até retornar false (abre espaço no buffer).
+void protocolo_recebe(protocolo_rx_t *rx, uint8_t byte, uint32_t agora_ms);
+
+// Entrega o próximo quadro válido já no buffer; false quando não há mais.
+// Chamada também sem bytes novos, abandona o quadro parcial expirado.
+bool protocolo_proximo(protocolo_rx_t *rx, uint32_t agora_ms, protocolo_msg_t *msg);
+
+// Monta o quadro em `saida` (PROTO_MAX_QUADRO bytes) e retorna o tamanho
+size_t protocolo_monta(uint8_t *saida, uint8_t tipo, const void *dados, uint8_t tamanho);
+
+#endif
@@ -0,0 +1,50 @@
+#include "repeticao.h"
+
+void repeticao_solta(repeticao_t *r) {
+    r->sentido = 0;
+    r->inicio_ms = 0;
+    r->proximo_ms = 0;
+}
+
+uint32_t repeticao_intervalo(const repeticao_config_t *cfg, uint8_t deflexao, uint32_t segurando_ms) {
+    // Tempo de aceleração: interpola do intervalo lento ao rápido
+    uint32_t acelerando = segurando_ms > cfg->atraso_inicial_ms ? segurando_ms - cfg->atraso_inicial_ms : 0;
+    if (acelerando > cfg->tempo_aceleracao_ms) acelerando = cfg->tempo_aceleracao_ms;
+    uint32_t faixa = cfg->intervalo_lento_ms - cfg->intervalo_rapido_ms;
+    uint32_t intervalo = cfg->intervalo_lento_ms;
+    if (cfg->tempo_aceleracao_ms > 0) intervalo -= faixa * acelerando / cfg->tempo_aceleracao_ms;
+
+    // Deflexão: x2 no limiar, x1 no fim do curso
+    if (deflexao > 100) deflexao = 100;
+    if (deflexao < cfg->deflexao_minima) deflexao = cfg->deflexao_minima;
+    uint32_t curso = 100 - cfg->deflexao_minima;
+    if (curso > 0) intervalo += intervalo * (100 - deflexao) / curso;
+    return intervalo;
+}
+
+int repeticao_atualiza(repeticao_t *r, const repeticao_config_t *cfg, int deflexao, uint32_t agora_ms) {
+    int8_t sentido = deflexao > 0 ? 1 : (deflexao < 0 ? -1 : 0);
+    uint8_t modulo = (uint8_t)(deflexao < 0 ? -deflexao : deflexao);
+    if (modulo < cfg->deflexao_minima) {
+        repeticao_solta(r);
+        return 0;
+    }
+
+    if (sentido != r->sentido) {
+        r->sentido = sentido;
+        r->inicio_ms = agora_ms;
+        r->proximo_ms = agora_ms + cfg->atraso_inicial_ms;
+        return sentido;
+    }
+
+    int passos = 0;
+    while ((int32_t)(agora_ms - r->proximo_ms) >= 0 && passos < cfg->max_passos) {
+        passos++;
+        r->proximo_ms += repeticao_intervalo(cfg, modulo, r->proximo_ms - r->inicio_ms);
+    }
+    // Depois de uma rajada limitada, volta a contar a partir de agora
+    if ((int32_t)(agora_ms - r->proximo_ms) >= 0) {
+        r->proximo_ms = agora_ms + repeticao_intervalo(cfg, modulo, agora_ms - r->inicio_ms);
+    }
+    return passos * sentido;
+}
@@ -0,0 +1,42 @@
+#ifndef REPETICAO_H
+#define REPETICAO_H
+
+// Auto-repetição com aceleração para entrada por joystick.
+//
+// Ao inclinar o joystick sai um passo imediato; mantendo a inclinação, depois
+// de `atraso_inicial_ms` os passos se repetem, começando a cada
+// `intervalo_lento_ms` e acelerando até `intervalo_rapido_ms` ao longo de
+// `tempo_aceleracao_ms`. Inclinações menores alongam o intervalo (até o
+// dobro no limiar), dando controle fino sem trocar de modo.
+//
+// Módulo puro (sem hardware): o tempo e a deflexão vêm do chamador, então a
+// curva pode ser exercitada no host com entradas sintéticas.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct {
+    uint8_t deflexao_minima;        // % do curso; abaixo disso é solto
+    uint16_t atraso_inicial_ms;
+    uint16_t intervalo_lento_ms;
+    uint16_t intervalo_rapido_ms;
+    uint16_t tempo_aceleracao_ms;   // após o atraso inicial
+    uint8_t max_passos;             // por chamada (limita rajadas após atraso)
+} repeticao_config_t;
+
+typedef struct {
+    int8_t sentido;                 // -1, 0 (solto) ou +1
+    uint32_t inicio_ms;
+    uint32_t proximo_ms;
+} repeticao_t;
+
+void repeticao_solta(repeticao_t *r);
+
+// Intervalo entre repetições após `segurando_ms` com deflexão `deflexao` (%)
+uint32_t repeticao_intervalo(const repeticao_config_t *cfg, uint8_t deflexao, uint32_t segurando_ms);
+
+// deflexao: -100..100 (% do curso, sinal = sentido). Retorna os passos (com
+// sinal) a aplicar agora; 0 se nada mudou.
+int repeticao_atualiza(repeticao_t *r, const repeticao_config_t *cfg, int deflexao, uint32_t agora_ms);
+
+#endif
@@ -1,88 +1,8 @@
 #include "ssd1306.h"
 #include "font.h"
 
-void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c) {
-  ssd->width = width;
-  ssd->height = height;
-  ssd->pages = height / 8U;
-  ssd->address = address;
-  ssd->i2c_port = i2c;
-  ssd->bufsize = ssd->pages * ssd->width + 1;
-  ssd->ram_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
-  ssd->ram_buffer[0] = 0x40;
-  ssd->port_buffer[0] = 0x80;
-}
-
-void ssd1306_config(ssd1306_t *ssd) {
-  ssd1306_command(ssd, SET_DISP | 0x00);
-  ssd1306_command(ssd, SET_MEM_ADDR);
-  ssd1306_command(ssd, 0x01);
-  ssd1306_command(ssd, SET_DISP_START_LINE | 0x00);
-  ssd1306_command(ssd, SET_SEG_REMAP | 0x01);
-  ssd1306_command(ssd, SET_MUX_RATIO);
-  ssd1306_command(ssd, HEIGHT - 1);
-  ssd1306_command(ssd, SET_COM_OUT_DIR | 0x08);
-  ssd1306_command(ssd, SET_DISP_OFFSET);
-  ssd1306_command(ssd, 0x00);
-  ssd1306_command(ssd, SET_COM_PIN_CFG);
-  ssd1306_command(ssd, 0x12);
-  ssd1306_command(ssd, SET_DISP_CLK_DIV);
-  ssd1306_command(ssd, 0x80);
-  ssd1306_command(ssd, SET_PRECHARGE);
-  ssd1306_command(ssd, 0xF1);
-  ssd1306_command(ssd, SET_VCOM_DESEL);
-  ssd1306_command(ssd, 0x30);
-  ssd1306_command(ssd, SET_CONTRAST);
-  ssd1306_command(ssd, 0xFF);
-  ssd1306_command(ssd, SET_ENTIRE_ON);
-  ssd1306_command(ssd, SET_NORM_INV);
-  ssd1306_command(ssd, SET_CHARGE_PUMP);
-  ssd1306_command(ssd, 0x14);
-  ssd1306_command(ssd, SET_DISP | 0x01);
-}
-
-void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
-  ssd->port_buffer[1] = command;
-  i2c_write_blocking(
-    ssd->i2c_port,
-    ssd->address,
-    ssd->port_buffer,
-    2,
-    false
-  );
-}
-
-void ssd1306_send_data(ssd1306_t *ssd) {
-  ssd1306_command(ssd, SET_COL_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->width - 1);
-  ssd1306_command(ssd, SET_PAGE_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->pages - 1);
-  i2c_write_blocking(
-    ssd->i2c_port,
-    ssd->address,
-    ssd->ram_buffer,
-    ssd->bufsize,
-    false
-  );
-}
-
-void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value) {
-  uint16_t index = (y >> 3) + (x << 3) + 1;
-  uint8_t pixel = (y & 0b111);
-  if (value)
-    ssd->ram_buffer[index] |= (1 << pixel);
-  else
-    ssd->ram_buffer[index] &= ~(1 << pixel);
-}
-
 void ssd1306_fill(ssd1306_t *ssd, bool value) {
-    for (uint8_t y = 0; y < ssd->height; ++y) {
-        for (uint8_t x = 0; x < ssd->width; ++x) {
-            ssd1306_pixel(ssd, x, y, value);
-        }
-    }
+  ssd1306_fill_area(ssd, 0, 0, ssd->width, ssd->height, value ? SSD1306_OP_SET : SSD1306_OP_CLEAR);
 }
 
 void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill) {
@@ -179,19 +99,16 @@ void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y)
   }
 }
 
-void ssd1306_init_config_clean(ssd1306_t *ssd,uint SCL,uint SDA,i2c_inst_t *PORT,uint8_t address) {
-  i2c_init(PORT, 400 * 1000);
-  gpio_set_function(SDA, GPIO_FUNC_I2C);
-  gpio_set_function(SCL, GPIO_FUNC_I2C);
-  gpio_pull_up(SDA);
-  gpio_pull_up(SCL);
-
-  ssd1306_init(ssd,WIDTH,HEIGHT,false,address,PORT);
-  ssd1306_config(ssd);
-  ssd1306_send_data(ssd);
-
-  ssd1306_fill(ssd,false);
-  ssd1306_send_data(ssd);
+// Desenha uma tela gerada por tools/gera_telas.py: linhas de texto como
+// x, y, n e n indices de glifo na fonte, terminadas por 0xFF. Cada glifo
+// e copiado byte a byte (mesmo resultado de ssd1306_draw_char).
+void ssd1306_draw_compressed(ssd1306_t *ssd, const uint8_t *data) {
+  while (*data != 0xFF) {
+    uint8_t x = data[0], y = data[1], n = data[2];
+    data += 3;
+    for (uint8_t i = 0; i < n; ++i, x += 8)
+      ssd1306_blit(ssd, &font[*data++ * 8], NULL, 8, 8, x, y, SSD1306_OP_COPY);
+  }
 }
 
 void ssd1306_select_edge(ssd1306_t *ssd,uint type,bool cor) {
@@ -213,3 +130,88 @@ void ssd1306_select_edge(ssd1306_t *ssd,uint type,bool cor) {
       break;
   }
 }
+
+void ssd1306_set_viewport(ssd1306_t *ssd, int x, int y, int width, int height) {
+  int x1 = x + width;
+  int y1 = y + height;
+  if (x < 0) x = 0;
+  if (y < 0) y = 0;
+  if (x1 > ssd->width) x1 = ssd->width;
+  if (y1 > ssd->height) y1 = ssd->height;
+  if (x1 < x) x1 = x;
+  if (y1 < y) y1 = y;
+  ssd->clip_x0 = x;
+  ssd->clip_y0 = y;
+  ssd->clip_x1 = x1;
+  ssd->clip_y1 = y1;
+}
+
+void ssd1306_reset_viewport(ssd1306_t *ssd) {
+  ssd1306_set_viewport(ssd, 0, 0, ssd->width, ssd->height);
+}
+
+// Le 8 linhas de uma coluna do bitmap a partir da linha `row` (pode ser
+// negativa ou cruzar a fronteira entre paginas). NULL representa um bitmap
+// todo aceso.
+static inline uint8_t ssd1306_fetch(const uint8_t *column, uint8_t pages, int row) {
+  if (!column)
+    return 0xFF;
+  if (row < 0)
+    return column[0] << -row;
+  uint8_t page = row >> 3;
+  uint8_t shift = row & 7;
+  uint8_t value = column[page] >> shift;
+  if (shift && page + 1 < pages)
+    value |= column[page + 1] << (8 - shift);
+  return value;
+}
+
+static inline void ssd1306_apply(uint8_t *dst, uint8_t src, uint8_t mask, ssd1306_op_t op) {
+  switch (op) {
+    case SSD1306_OP_COPY:   *dst = (*dst & ~mask) | (src & mask); break;
+    case SSD1306_OP_SET:    *dst |= src & mask; break;
+    case SSD1306_OP_CLEAR:  *dst &= ~(src & mask); break;
+    case SSD1306_OP_XOR:    *dst ^= src & mask; break;
+    case SSD1306_OP_INVERT: *dst = (*dst & ~mask) | (~src & mask); break;
+  }
+}
+
+// Bitmap e mascara no formato nativo do display: coluna a coluna, cada coluna
+// com (height + 7) / 8 bytes, bit 0 = linha de cima da pagina. A mascara
+// (opcional) seleciona os pixels afetados; bitmap NULL desenha um bloco cheio.
+// Tudo e recortado pelo viewport e processado um byte (8 linhas) por vez.
+void ssd1306_blit(ssd1306_t *ssd, const uint8_t *bitmap, const uint8_t *mask, uint8_t width, uint8_t height, int x, int y, ssd1306_op_t op) {
+  int x0 = x > ssd->clip_x0 ? x : ssd->clip_x0;
+  int y0 = y > ssd->clip_y0 ? y : ssd->clip_y0;
+  int x1 = x + width < ssd->clip_x1 ? x + width : ssd->clip_x1;
+  int y1 = y + height < ssd->clip_y1 ? y + height : ssd->clip_y1;
+  if (x0 >= x1 || y0 >= y1)
+    return;
+
+  uint8_t src_pages = (height + 7) / 8;
+  int first_page = y0 >> 3;
+  int last_page = (y1 - 1) >> 3;
+
+  for (int page = first_page; page <= last_page; ++page) {
+    uint8_t clip = 0xFF;
+    if (page == first_page)
+      clip &= 0xFF << (y0 & 7);
+    if (page == last_page)
+      clip &= 0xFF >> (7 - ((y1 - 1) & 7));
+    int row = page * 8 - y;
+
+    uint8_t *dst = &ssd->ram_buffer[x0 * ssd->pages + page + 1];
+    for (int col = x0; col < x1; ++col, dst += ssd->pages) {
+      int offset = (col - x) * src_pages;
+      uint8_t src = ssd1306_fetch(bitmap ? bitmap + offset : NULL, src_pages, row);
+      uint8_t m = ssd1306_fetch(mask ? mask + offset : NULL, src_pages, row);
+      ssd1306_apply(dst, src, m & clip, op);
+    }
+  }
+}
+
+void ssd1306_fill_area(ssd1306_t *ssd, int x, int y, int width, int height, ssd1306_op_t op) {
+  if (width <= 0 || height <= 0)
+    return;
+  ssd1306_blit(ssd, NULL, NULL, width > 255 ? 255 : width, height > 255 ? 255 : height, x, y, op);
+}
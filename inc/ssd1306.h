@@ -25,6 +25,14 @@ typedef enum {
   SET_CHARGE_PUMP = 0x8D
 } ssd1306_command_t;
 
+typedef enum {
+  SSD1306_OP_COPY,
+  SSD1306_OP_SET,
+  SSD1306_OP_CLEAR,
+  SSD1306_OP_XOR,
+  SSD1306_OP_INVERT
+} ssd1306_op_t;
+
 typedef struct {
   uint8_t width, height, pages, address;
   i2c_inst_t *i2c_port;
@@ -32,11 +40,18 @@ typedef struct {
   uint8_t *ram_buffer;
   size_t bufsize;
   uint8_t port_buffer[2];
+  uint8_t clip_x0, clip_y0, clip_x1, clip_y1;
 } ssd1306_t;
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c);
 void ssd1306_config(ssd1306_t *ssd);
 void ssd1306_command(ssd1306_t *ssd, uint8_t command);
+void ssd1306_commands(ssd1306_t *ssd, const uint8_t *commands, size_t count);
+void ssd1306_power(ssd1306_t *ssd, bool on);
 void ssd1306_send_data(ssd1306_t *ssd);
 
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value);
@@ -47,5 +62,15 @@ void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value
 void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value);
 void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y);
 void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y);
-void ssd1306_init_config_clean(ssd1306_t *ssd,uint SCL,uint SDA,i2c_inst_t *PORT,uint8_t address);
-void ssd1306_select_edge(ssd1306_t *ssd,uint type,bool cor);
\ No newline at end of file
+void ssd1306_init_config(ssd1306_t *ssd,uint SCL,uint SDA,i2c_inst_t *PORT,uint8_t address);
+void ssd1306_select_edge(ssd1306_t *ssd,uint type,bool cor);
+
+void ssd1306_set_viewport(ssd1306_t *ssd, int x, int y, int width, int height);
+void ssd1306_reset_viewport(ssd1306_t *ssd);
+void ssd1306_blit(ssd1306_t *ssd, const uint8_t *bitmap, const uint8_t *mask, uint8_t width, uint8_t height, int x, int y, ssd1306_op_t op);
+void ssd1306_fill_area(ssd1306_t *ssd, int x, int y, int width, int height, ssd1306_op_t op);
+void ssd1306_draw_compressed(ssd1306_t *ssd, const uint8_t *data);
+
+#ifdef __cplusplus
+}
+#endif
\ No newline at end of file
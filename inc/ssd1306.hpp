@@ -0,0 +1,136 @@
+#ifndef SSD1306_HPP
+#define SSD1306_HPP
+
+// Driver SSD1306 especializado em tempo de compilação.
+//
+// Largura, altura, transporte e rotação são parâmetros do template: o
+// framebuffer é um std::array do tamanho exato (sem heap) e índice, máscara,
+// janela de colunas e sequência de configuração são constexpr. A rotação é
+// feita pelo próprio controlador (remapeamento de segmentos e direção de
+// varredura COM), então o layout do buffer é o mesmo em qualquer rotação e
+// as rotinas de desenho de ssd1306.c continuam valendo.
+//
+// Transport precisa de `void write(const uint8_t *data, size_t length) const`
+// que envie uma transação completa ao controlador.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "ssd1306.h"
+
+namespace ssd1306 {
+
+enum class Rotation { None, Rot180, MirrorX, MirrorY };
+
+struct I2cTransport {
+  i2c_inst_t *port = nullptr;
+  uint8_t address = 0x3C;
+
+  void write(const uint8_t *data, size_t length) const {
+    i2c_write_blocking(port, address, data, length, false);
+  }
+};
+
+template <uint8_t Width, uint8_t Height, typename Transport, Rotation Rot = Rotation::None>
+class Ssd1306 {
+  static_assert(Width > 0 && Width <= 128, "SSD1306 tem no maximo 128 colunas");
+  static_assert(Height > 0 && Height <= 64 && Height % 8 == 0, "altura deve ser multiplo de 8, ate 64");
+
+public:
+  static constexpr uint8_t width = Width;
+  static constexpr uint8_t height = Height;
+  static constexpr uint8_t pages = Height / 8;
+  // Painéis mais estreitos (ex.: 72x40) usam as colunas centrais da GDDRAM
+  static constexpr uint8_t column_offset = (128 - Width) / 2;
+  static constexpr size_t buffer_size = size_t(Width) * pages + 1;
+
+  // Endereçamento vertical: coluna a coluna, `pages` bytes por coluna; o
+  // byte 0 do buffer é o byte de controle 0x40 da transação de dados.
+  static constexpr size_t index(uint8_t x, uint8_t y) { return 1 + size_t(x) * pages + (y >> 3); }
+  static constexpr uint8_t mask(uint8_t y) { return uint8_t(1u << (y & 7)); }
+
+  Ssd1306() { buffer_[0] = 0x40; }
+  explicit Ssd1306(const Transport &transport) : transport_(transport) { buffer_[0] = 0x40; }
+
+  void attach(const Transport &transport) { transport_ = transport; }
+
+  uint8_t *data() { return buffer_.data(); }
+  const uint8_t *data() const { return buffer_.data(); }
+
+  // Toda a configuração em uma transação; o painel continua desligado
+  void config() const { transport_.write(config_sequence.data(), config_sequence.size()); }
+
+  void command(uint8_t command) const {
+    const uint8_t packet[2] = {0x00, command};
+    transport_.write(packet, sizeof(packet));
+  }
+
+  void commands(const uint8_t *commands, size_t count) const {
+    uint8_t packet[32];
+    while (count > 0) {
+      size_t n = count < sizeof(packet) - 1 ? count : sizeof(packet) - 1;
+      packet[0] = 0x00;
+      for (size_t i = 0; i < n; i++) packet[i + 1] = commands[i];
+      transport_.write(packet, n + 1);
+      commands += n;
+      count -= n;
+    }
+  }
+
+  void power(bool on) const { command(on ? SET_DISP | 0x01 : SET_DISP | 0x00); }
+
+  void send() const {
+    transport_.write(window_sequence.data(), window_sequence.size());
+    transport_.write(buffer_.data(), buffer_.size());
+  }
+
+  void pixel(uint8_t x, uint8_t y, bool value) {
+    if (x >= Width || y >= Height) return;
+    put(x, y, value);
+  }
+
+  // Sem checagem de limites, para quem já recortou (o viewport da API C
+  // nunca passa de width x height)
+  void put(uint8_t x, uint8_t y, bool value) {
+    if (value)
+      buffer_[index(x, y)] |= mask(y);
+    else
+      buffer_[index(x, y)] &= uint8_t(~mask(y));
+  }
+
+private:
+  static constexpr bool flip_segments = Rot == Rotation::Rot180 || Rot == Rotation::MirrorX;
+  static constexpr bool flip_com = Rot == Rotation::Rot180 || Rot == Rotation::MirrorY;
+
+  static constexpr std::array<uint8_t, 25> config_sequence = {
+    0x00,   // controle: só comandos
+    SET_DISP | 0x00,
+    SET_MEM_ADDR, 0x01,
+    SET_DISP_START_LINE | 0x00,
+    flip_segments ? SET_SEG_REMAP | 0x00 : SET_SEG_REMAP | 0x01,
+    SET_MUX_RATIO, Height - 1,
+    flip_com ? SET_COM_OUT_DIR | 0x00 : SET_COM_OUT_DIR | 0x08,
+    SET_DISP_OFFSET, 0x00,
+    SET_COM_PIN_CFG, (Width == 128 && Height == 32) ? 0x02 : 0x12,
+    SET_DISP_CLK_DIV, 0x80,
+    SET_PRECHARGE, 0xF1,
+    SET_VCOM_DESEL, 0x30,
+    SET_CONTRAST, 0xFF,
+    SET_ENTIRE_ON,
+    SET_NORM_INV,
+    SET_CHARGE_PUMP, 0x14
+  };
+
+  static constexpr std::array<uint8_t, 7> window_sequence = {
+    0x00,
+    SET_COL_ADDR, column_offset, column_offset + Width - 1,
+    SET_PAGE_ADDR, 0, pages - 1
+  };
+
+  Transport transport_{};
+  std::array<uint8_t, buffer_size> buffer_{};
+};
+
+}  // namespace ssd1306
+
+#endif
@@ -0,0 +1,90 @@
+// API C ssd1306_* sobre uma instância estática de ssd1306::Ssd1306.
+//
+// Inicialização, configuração, envio e escrita de pixel ficam no template;
+// as rotinas de desenho de ssd1306.c continuam operando em ram_buffer, que
+// agora aponta para o std::array da instância (sem calloc). A geometria é
+// escolhida na compilação (SSD1306_PANEL_*); há um único painel por firmware.
+
+#include "ssd1306.hpp"
+
+#ifndef SSD1306_PANEL_WIDTH
+#define SSD1306_PANEL_WIDTH WIDTH
+#endif
+#ifndef SSD1306_PANEL_HEIGHT
+#define SSD1306_PANEL_HEIGHT HEIGHT
+#endif
+#ifndef SSD1306_PANEL_ROTATION
+#define SSD1306_PANEL_ROTATION None
+#endif
+
+using Panel = ssd1306::Ssd1306<SSD1306_PANEL_WIDTH, SSD1306_PANEL_HEIGHT, ssd1306::I2cTransport,
+                               ssd1306::Rotation::SSD1306_PANEL_ROTATION>;
+
+static Panel panel;
+
+extern "C" {
+
+void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c) {
+  if (width != Panel::width || height != Panel::height)
+    panic("ssd1306: firmware compilado para painel %ux%u", Panel::width, Panel::height);
+  panel.attach({i2c, address});
+  ssd->width = Panel::width;
+  ssd->height = Panel::height;
+  ssd->pages = Panel::pages;
+  ssd->address = address;
+  ssd->i2c_port = i2c;
+  ssd->external_vcc = external_vcc;
+  ssd->bufsize = Panel::buffer_size;
+  ssd->ram_buffer = panel.data();
+  ssd->port_buffer[0] = 0x80;
+  ssd1306_reset_viewport(ssd);
+}
+
+void ssd1306_config(ssd1306_t *ssd) {
+  (void)ssd;
+  panel.config();
+  panel.power(true);
+}
+
+void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
+  (void)ssd;
+  panel.command(command);
+}
+
+void ssd1306_commands(ssd1306_t *ssd, const uint8_t *commands, size_t count) {
+  (void)ssd;
+  panel.commands(commands, count);
+}
+
+void ssd1306_power(ssd1306_t *ssd, bool on) {
+  (void)ssd;
+  panel.power(on);
+}
+
+void ssd1306_send_data(ssd1306_t *ssd) {
+  (void)ssd;
+  panel.send();
+}
+
+void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value) {
+  if (x < ssd->clip_x0 || x >= ssd->clip_x1 || y < ssd->clip_y0 || y >= ssd->clip_y1)
+    return;
+  panel.put(x, y, value);
+}
+
+// Configura o barramento e o controlador com o painel ainda desligado. O
+// buffer começa zerado: desenhe o primeiro quadro, envie com
+// ssd1306_send_data e só então ligue com ssd1306_power(ssd, true), para que
+// o conteúdo aleatório da GDDRAM nunca apareça.
+void ssd1306_init_config(ssd1306_t *ssd, uint SCL, uint SDA, i2c_inst_t *PORT, uint8_t address) {
+  i2c_init(PORT, 400 * 1000);
+  gpio_set_function(SDA, GPIO_FUNC_I2C);
+  gpio_set_function(SCL, GPIO_FUNC_I2C);
+  gpio_pull_up(SDA);
+  gpio_pull_up(SCL);
+
+  ssd1306_init(ssd, Panel::width, Panel::height, false, address, PORT);
+  panel.config();
+}
+
+}
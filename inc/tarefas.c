@@ -0,0 +1,47 @@
+#include "tarefas.h"
+#include "hardware/sync.h"
+
+#define TAREFAS_MAX 12
+
+static struct {
+    tarefa_t *ctx;
+    tarefa_funcao_t funcao;
+} tarefas[TAREFAS_MAX];
+static uint num_tarefas = 0;
+
+static volatile bool sinal = false;
+static uint64_t proximo_prazo = TAREFA_SEM_PRAZO;
+
+void tarefas_adiciona(tarefa_t *t, tarefa_funcao_t funcao) {
+    if (num_tarefas >= TAREFAS_MAX) panic("tarefas: limite de %d tarefas", TAREFAS_MAX);
+    t->linha = 0;
+    t->prazo_us = TAREFA_SEM_PRAZO;
+    tarefas[num_tarefas].ctx = t;
+    tarefas[num_tarefas].funcao = funcao;
+    num_tarefas++;
+}
+
+// Pode ser chamada de interrupções: acorda o escalonador para mais uma rodada.
+void tarefas_sinaliza(void) {
+    sinal = true;
+    __sev();
+}
+
+void tarefas_prazo(uint64_t prazo_us) {
+    if (prazo_us < proximo_prazo) proximo_prazo = prazo_us;
+}
+
+void tarefas_executa(void) {
+    while (true) {
+        sinal = false;
+        proximo_prazo = TAREFA_SEM_PRAZO;
+        for (uint i = 0; i < num_tarefas; i++) {
+            tarefas[i].funcao(tarefas[i].ctx);
+        }
+        // Um sinal durante a rodada (ou vindo de IRQ) pede outra rodada; o
+        // __sev() da interrupção impede que o WFE perca o evento.
+        if (!sinal) {
+            best_effort_wfe_or_timeout(from_us_since_boot(proximo_prazo));
+        }
+    }
+}
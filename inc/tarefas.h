@@ -0,0 +1,67 @@
+#ifndef TAREFAS_H
+#define TAREFAS_H
+
+// Tarefas cooperativas sem pilha (no estilo protothreads).
+//
+// Cada tarefa é uma função chamada repetidamente pelo escalonador; as macros
+// TAREFA_* guardam em `linha` o ponto onde ela parou e retornam, e na próxima
+// chamada o switch retoma dali. Consequências:
+//   - variáveis locais não sobrevivem a uma espera: use `static` ou o estado
+//     global da tarefa;
+//   - não use `switch` no corpo da tarefa entre TAREFA_INICIO e TAREFA_FIM
+//     (os `case` das macros ficariam no switch errado); use if/else.
+//
+// Quando nenhuma tarefa avança, o escalonador dorme (WFE) até o prazo mais
+// próximo ou até tarefas_sinaliza() ser chamada (ex.: por uma interrupção).
+
+#include "pico/stdlib.h"
+
+typedef struct {
+    uint16_t linha;       // ponto de retomada (0 = início)
+    uint64_t prazo_us;    // prazo da espera em andamento
+} tarefa_t;
+
+typedef enum {
+    TAREFA_ESPERANDO,
+    TAREFA_TERMINOU
+} tarefa_estado_t;
+
+typedef tarefa_estado_t (*tarefa_funcao_t)(tarefa_t *t);
+
+#define TAREFA_SEM_PRAZO UINT64_MAX
+
+#define TAREFA_INICIO(t) switch ((t)->linha) { case 0:
+
+#define TAREFA_FIM(t) } (t)->linha = 0; return TAREFA_TERMINOU
+
+// Espera `cond` ficar verdadeira ou o instante absoluto `prazo` (time_us_64)
+// chegar, o que ocorrer primeiro.
+#define TAREFA_ESPERA_ATE_PRAZO(t, cond, prazo)                          \
+    do {                                                                \
+        (t)->prazo_us = (prazo);                                        \
+        (t)->linha = __LINE__; case __LINE__:                           \
+        if (!(cond) && time_us_64() < (t)->prazo_us) {                  \
+            tarefas_prazo((t)->prazo_us);                               \
+            return TAREFA_ESPERANDO;                                    \
+        }                                                               \
+        tarefas_sinaliza();                                             \
+    } while (0)
+
+#define TAREFA_ESPERA_ATE(t, cond) TAREFA_ESPERA_ATE_PRAZO(t, cond, TAREFA_SEM_PRAZO)
+
+#define TAREFA_DORME_MS(t, ms) \
+    TAREFA_ESPERA_ATE_PRAZO(t, false, time_us_64() + (uint64_t)(ms) * 1000u)
+
+// Executa a subtarefa `chamada` (que recebe `filho`) até ela terminar.
+#define TAREFA_EXECUTA(t, filho, chamada)                               \
+    do {                                                                \
+        (filho)->linha = 0;                                             \
+        TAREFA_ESPERA_ATE(t, (chamada) == TAREFA_TERMINOU);             \
+    } while (0)
+
+void tarefas_adiciona(tarefa_t *t, tarefa_funcao_t funcao);
+void tarefas_executa(void);
+void tarefas_sinaliza(void);
+void tarefas_prazo(uint64_t prazo_us);
+
+#endif
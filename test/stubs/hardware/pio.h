@@ -0,0 +1,9 @@
+#ifndef TESTE_HARDWARE_PIO_H
+#define TESTE_HARDWARE_PIO_H
+
+#include "pico/stdlib.h"
+
+typedef struct pio_hw pio_hw_t;
+typedef pio_hw_t *PIO;
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef TESTE_PICO_STDLIB_H
+#define TESTE_PICO_STDLIB_H
+
+// Só o necessário para compilar os módulos puros de inc/ no host; as funções
+// declaradas aqui são definidas pelo teste que as usa
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef unsigned int uint;
+
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum gpio_function { GPIO_FUNC_I2C = 3 };
+
+void gpio_set_function(uint gpio, enum gpio_function fn);
+void gpio_pull_up(uint gpio);
+void panic(const char *fmt, ...);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,276 @@
+// Modelo no host do debounce em PIO (inc/botoes.pio) e da decodificação dos
+// eventos (botoes_pio_decodifica). O programa é lido do próprio .pio e
+// executado ciclo a ciclo por um interpretador do subconjunto de instruções
+// que ele usa, com o pino dado por uma forma de onda em amostras.
+
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "teste.h"
+#include "botoes_pio.h"
+
+#define CICLOS_POR_AMOSTRA 4   // BOTOES_CICLOS_POR_AMOSTRA em botoes.pio
+#define MAX_INSTRUCOES 32
+#define MAX_EVENTOS 64
+
+typedef enum { SET_Y, JMP_SEMPRE, JMP_X_DEC, JMP_Y_DEC, JMP_PINO, IN_X, IN_Y, IN_NULL, PUSH } operacao_t;
+
+typedef struct {
+    operacao_t op;
+    int valor;          // set / in: valor ou bits
+    char alvo[32];      // jmp: rótulo
+    int destino;
+    int atraso;
+} instrucao_t;
+
+static instrucao_t programa[MAX_INSTRUCOES];
+static int num_instrucoes = 0;
+static int inicio_wrap = 0, fim_wrap = -1;
+static int amostras_debounce = 0;
+
+static struct { char nome[32]; int endereco; } rotulos[MAX_INSTRUCOES];
+static int num_rotulos = 0;
+
+static char *limpa(char *s) {
+    while (isspace((unsigned char)*s)) s++;
+    char *fim = s + strlen(s);
+    while (fim > s && isspace((unsigned char)fim[-1])) *--fim = 0;
+    return s;
+}
+
+// Expressões usadas no programa: número, AMOSTRAS ou (AMOSTRAS - n)
+static int avalia(const char *expr) {
+    char tmp[64];
+    int j = 0;
+    for (const char *c = expr; *c && j < 63; c++) {
+        if (*c != '(' && *c != ')' && !isspace((unsigned char)*c)) tmp[j++] = *c;
+    }
+    tmp[j] = 0;
+    int base = 0;
+    const char *resto = tmp;
+    if (strncmp(tmp, "AMOSTRAS", 8) == 0) {
+        base = amostras_debounce;
+        resto = tmp + 8;
+    } else {
+        base = (int)strtol(tmp, (char **)&resto, 0);
+    }
+    if (*resto == '-') base -= atoi(resto + 1);
+    if (*resto == '+') base += atoi(resto + 1);
+    return base;
+}
+
+static void carrega_programa(const char *caminho) {
+    FILE *f = fopen(caminho, "r");
+    if (!f) {
+        fprintf(stderr, "não abriu %s\n", caminho);
+        exit(2);
+    }
+    char linha[256];
+    while (fgets(linha, sizeof(linha), f)) {
+        if (linha[0] == '%') break;            // bloco c-sdk
+        char *ponto_virgula = strchr(linha, ';');
+        if (ponto_virgula) *ponto_virgula = 0;
+        char *s = limpa(linha);
+        if (!*s) continue;
+
+        if (strncmp(s, ".define public AMOSTRAS", 23) == 0) {
+            amostras_debounce = atoi(s + 23);
+            continue;
+        }
+        if (strcmp(s, ".wrap_target") == 0) { inicio_wrap = num_instrucoes; continue; }
+        if (strcmp(s, ".wrap") == 0) { fim_wrap = num_instrucoes - 1; continue; }
+        if (s[0] == '.') continue;
+        size_t n = strlen(s);
+        if (s[n - 1] == ':') {
+            s[n - 1] = 0;
+            snprintf(rotulos[num_rotulos].nome, sizeof(rotulos[0].nome), "%s", s);
+            rotulos[num_rotulos++].endereco = num_instrucoes;
+            continue;
+        }
+
+        instrucao_t *i = &programa[num_instrucoes++];
+        memset(i, 0, sizeof(*i));
+        char *colchete = strchr(s, '[');
+        if (colchete) {
+            i->atraso = atoi(colchete + 1);
+            *colchete = 0;
+            s = limpa(s);
+        }
+        char a[32] = "", b[32] = "", c[32] = "";
+        sscanf(s, "%31s %31[^,\n ] %31s", a, b, c);
+        char *virgula = strchr(s, ',');
+        if (strcmp(a, "set") == 0) {
+            i->op = SET_Y;
+            i->valor = avalia(virgula + 1);
+        } else if (strcmp(a, "jmp") == 0) {
+            if (c[0]) {
+                i->op = strcmp(b, "x--") == 0 ? JMP_X_DEC : strcmp(b, "y--") == 0 ? JMP_Y_DEC : JMP_PINO;
+                snprintf(i->alvo, sizeof(i->alvo), "%s", c);
+            } else {
+                i->op = JMP_SEMPRE;
+                snprintf(i->alvo, sizeof(i->alvo), "%s", b);
+            }
+        } else if (strcmp(a, "in") == 0) {
+            i->op = strcmp(b, "x") == 0 ? IN_X : strcmp(b, "y") == 0 ? IN_Y : IN_NULL;
+            i->valor = avalia(virgula + 1);
+        } else if (strcmp(a, "push") == 0) {
+            i->op = PUSH;
+        } else {
+            fprintf(stderr, "instrução não modelada: %s\n", s);
+            exit(2);
+        }
+    }
+    fclose(f);
+
+    for (int k = 0; k < num_instrucoes; k++) {
+        if (programa[k].op < JMP_SEMPRE || programa[k].op > JMP_PINO) continue;
+        programa[k].destino = -1;
+        for (int r = 0; r < num_rotulos; r++) {
+            if (strcmp(rotulos[r].nome, programa[k].alvo) == 0) programa[k].destino = rotulos[r].endereco;
+        }
+        if (programa[k].destino < 0) {
+            fprintf(stderr, "rótulo desconhecido: %s\n", programa[k].alvo);
+            exit(2);
+        }
+    }
+}
+
+// ---------------------- SIMULAÇÃO ---------------------------
+typedef struct {
+    uint32_t palavra;
+    uint64_t ciclo;
+} evento_t;
+
+typedef bool (*forma_de_onda_t)(uint64_t amostra);
+
+static evento_t eventos[MAX_EVENTOS];
+static int num_eventos;
+
+// Roda `amostras` períodos de amostragem; o pino segue onda(ciclo / 4)
+static void simula(forma_de_onda_t onda, uint64_t amostras) {
+    uint32_t x = 0, y = 0, isr = 0;
+    int pc = 0;
+    num_eventos = 0;
+    for (uint64_t ciclo = 0; ciclo < amostras * CICLOS_POR_AMOSTRA;) {
+        const instrucao_t *i = &programa[pc];
+        bool pino = onda(ciclo / CICLOS_POR_AMOSTRA);
+        int proximo = (pc == fim_wrap) ? inicio_wrap : pc + 1;
+        switch (i->op) {
+        case SET_Y:      y = (uint32_t)i->valor; break;
+        case JMP_SEMPRE: proximo = i->destino; break;
+        case JMP_X_DEC:  if (x != 0) proximo = i->destino; x--; break;
+        case JMP_Y_DEC:  if (y != 0) proximo = i->destino; y--; break;
+        case JMP_PINO:   if (pino) proximo = i->destino; break;
+        case IN_X:       isr = (isr << i->valor) | (x & ((1u << i->valor) - 1)); break;
+        case IN_Y:       isr = (isr << i->valor) | (y & ((1u << i->valor) - 1)); break;
+        case IN_NULL:    isr <<= i->valor; break;
+        case PUSH:
+            if (num_eventos < MAX_EVENTOS) eventos[num_eventos++] = (evento_t){isr, ciclo};
+            isr = 0;
+            break;
+        }
+        ciclo += 1 + (uint64_t)i->atraso;
+        pc = proximo;
+    }
+}
+
+// ---------------------- FORMAS DE ONDA (true = solto) ---------------------------
+static bool sempre_solto(uint64_t a) { (void)a; return true; }
+
+// Pulsos baixos de 1 a AMOSTRAS-1 amostras, separados por 20 amostras altas
+static bool oscilacoes_curtas(uint64_t a) {
+    uint64_t bloco = a / 40, pos = a % 40;
+    uint64_t largura = 1 + bloco % (uint64_t)(amostras_debounce - 1);
+    return !(pos >= 20 && pos < 20 + largura);
+}
+
+// Aperto limpo de 1000 a 1999
+static bool aperto_limpo(uint64_t a) { return !(a >= 1000 && a < 2000); }
+
+// Aperto com 12 amostras de repique na entrada e na saída
+static bool aperto_com_repique(uint64_t a) {
+    if (a >= 1000 && a < 1012) return (a / 2) % 2;
+    if (a >= 1012 && a < 2000) return false;
+    if (a >= 2000 && a < 2012) return !((a / 2) % 2);
+    return true;
+}
+
+// Solto com falhas altas curtas durante o aperto (mau contato)
+static bool aperto_com_falhas(uint64_t a) {
+    if (a < 1000 || a >= 3000) return true;
+    return (a % 100) < (uint64_t)(amostras_debounce - 1) && a > 1100 && a < 2900;
+}
+
+static void decodifica(int k, bool *pressionado, uint32_t *tick) {
+    botoes_pio_decodifica(eventos[k].palavra, pressionado, tick);
+}
+
+// Tick esperado quando o nível estável começa na amostra `amostra`: o evento
+// sai depois de AMOSTRAS amostras, e cada evento anterior atrasa 1 amostra
+static void confere_tick(int k, uint64_t amostra) {
+    bool pressionado;
+    uint32_t tick;
+    decodifica(k, &pressionado, &tick);
+    long long esperado = (long long)amostra + amostras_debounce;
+    CONFERE(tick + 2 >= esperado - k && tick <= esperado + 1);
+}
+
+int main(void) {
+    carrega_programa(BOTOES_PIO);
+    CONFERE_IGUAL(5, amostras_debounce);
+
+    // Sem borda, sem evento
+    simula(sempre_solto, 10000);
+    CONFERE_IGUAL(0, num_eventos);
+
+    // Oscilações mais curtas que a janela nunca geram evento
+    simula(oscilacoes_curtas, 40 * 40);
+    CONFERE_IGUAL(0, num_eventos);
+
+    // Aperto e soltura limpos: dois eventos com nível e tick certos
+    bool pressionado;
+    uint32_t tick;
+    simula(aperto_limpo, 3000);
+    CONFERE_IGUAL(2, num_eventos);
+    decodifica(0, &pressionado, &tick);
+    CONFERE(pressionado);
+    confere_tick(0, 1000);
+    decodifica(1, &pressionado, &tick);
+    CONFERE(!pressionado);
+    confere_tick(1, 2000);
+
+    // Repique vira um evento só em cada borda
+    simula(aperto_com_repique, 3000);
+    CONFERE_IGUAL(2, num_eventos);
+    decodifica(0, &pressionado, &tick);
+    CONFERE(pressionado);
+    confere_tick(0, 1012);
+    decodifica(1, &pressionado, &tick);
+    CONFERE(!pressionado);
+    confere_tick(1, 2012);
+
+    // Falhas curtas durante o aperto não geram soltura
+    simula(aperto_com_falhas, 4000);
+    CONFERE_IGUAL(2, num_eventos);
+    decodifica(0, &pressionado, &tick);
+    CONFERE(pressionado);
+    decodifica(1, &pressionado, &tick);
+    CONFERE(!pressionado);
+    confere_tick(1, 3000);
+
+    // Decodificação: X começa em 0 e decrementa, só 31 bits vão no evento
+    uint32_t ticks[] = {0, 1, 5, 0x7FFFFFFEu, 0x7FFFFFFFu};
+    for (size_t k = 0; k < count_of(ticks); k++) {
+        uint32_t x = 0u - ticks[k];
+        botoes_pio_decodifica(((x & 0x7FFFFFFFu) << 1) | 0u, &pressionado, &tick);
+        CONFERE(pressionado);
+        CONFERE_IGUAL(ticks[k], tick);
+        botoes_pio_decodifica(((x & 0x7FFFFFFFu) << 1) | 1u, &pressionado, &tick);
+        CONFERE(!pressionado);
+    }
+    // Depois de 2^31 amostras (~24 dias a 1 kHz) o tick recomeça do zero
+    botoes_pio_decodifica(((0u - 0x80000003u) & 0x7FFFFFFFu) << 1, &pressionado, &tick);
+    CONFERE_IGUAL(3, tick);
+
+    FIM_TESTES();
+}
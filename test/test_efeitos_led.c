@@ -0,0 +1,83 @@
+// Tabelas dos efeitos do LED (inc/efeitos_led_tabela.c): gama, forma das
+// ondas e o empacotamento no layout de CC com um canal de nível fixo, como o
+// buzzer no slice 5 (canal A) ao lado do LED verde (canal B).
+
+#include "teste.h"
+#include "efeitos_led.h"
+
+static uint16_t gama[256];
+static uint32_t tabela[EFEITOS_PASSOS];
+
+static uint16_t metade(uint32_t palavra, uint canal) {
+    return (uint16_t)(palavra >> (16 * canal));
+}
+
+int main(void) {
+    efeitos_led_gera_gama(gama, 2.2f);
+    CONFERE_IGUAL(0, gama[0]);
+    CONFERE_IGUAL(EFEITOS_NIVEL_MAX, gama[255]);
+    bool monotona = true;
+    for (uint i = 1; i < 256; i++) monotona &= gama[i] >= gama[i - 1];
+    CONFERE(monotona);
+
+    // Respira: apagado no começo, cor cheia no meio, simétrico
+    efeito_led_t respira = {EFEITO_RESPIRA, {200, 100, 0}, {0, 0, 0}, 0};
+    cor_led_t c = efeitos_led_cor_no_passo(&respira, 0);
+    CONFERE_IGUAL(0, c.r);
+    c = efeitos_led_cor_no_passo(&respira, EFEITOS_PASSOS / 2 - 1);
+    CONFERE_IGUAL(200, c.r);
+    CONFERE_IGUAL(100, c.g);
+    bool simetrica = true;
+    for (uint p = 0; p < EFEITOS_PASSOS / 2; p++) {
+        cor_led_t a = efeitos_led_cor_no_passo(&respira, p);
+        cor_led_t b = efeitos_led_cor_no_passo(&respira, EFEITOS_PASSOS - 1 - p);
+        simetrica &= a.r == b.r && a.g == b.g && a.b == b.b;
+    }
+    CONFERE(simetrica);
+
+    // Transição: sai de `cor`, chega em `cor_final` no meio e volta
+    efeito_led_t transicao = {EFEITO_TRANSICAO, {255, 0, 10}, {0, 255, 10}, 0};
+    c = efeitos_led_cor_no_passo(&transicao, 0);
+    CONFERE(c.r == 255 && c.g == 0 && c.b == 10);
+    c = efeitos_led_cor_no_passo(&transicao, EFEITOS_PASSOS / 2 - 1);
+    CONFERE(c.r == 0 && c.g == 255 && c.b == 10);
+    c = efeitos_led_cor_no_passo(&transicao, EFEITOS_PASSOS - 1);
+    CONFERE(c.r == 255 && c.g == 0);
+
+    // Pisca: exatamente `piscadas` trechos acesos no período
+    for (uint8_t piscadas = 1; piscadas <= 4; piscadas++) {
+        efeito_led_t pisca = {EFEITO_PISCA, COR_AZUL, COR_AZUL, piscadas};
+        int acesos = 0;
+        bool antes = false;
+        for (uint p = 0; p < EFEITOS_PASSOS; p++) {
+            bool aceso = efeitos_led_cor_no_passo(&pisca, p).b != 0;
+            if (aceso && !antes) acesos++;
+            antes = aceso;
+        }
+        CONFERE_IGUAL(piscadas, acesos);
+    }
+
+    // Slice 5: buzzer fixo no canal A, verde no B. O nível do buzzer não muda
+    // ao longo da tabela e o verde segue a gama.
+    const int8_t componente[2] = {EFEITOS_SEM_LED, 1};
+    const uint16_t fixo[2] = {EFEITOS_NIVEL_MAX / 2, 0};
+    efeitos_led_preenche_tabela(tabela, &respira, gama, componente, fixo);
+    bool buzzer_constante = true, verde_certo = true;
+    for (uint p = 0; p < EFEITOS_PASSOS; p++) {
+        buzzer_constante &= metade(tabela[p], 0) == EFEITOS_NIVEL_MAX / 2;
+        verde_certo &= metade(tabela[p], 1) == gama[efeitos_led_cor_no_passo(&respira, p).g];
+    }
+    CONFERE(buzzer_constante);
+    CONFERE(verde_certo);
+    CONFERE_IGUAL(gama[100], metade(tabela[EFEITOS_PASSOS / 2 - 1], 1));
+
+    // Slice 6: azul no A, vermelho no B
+    const int8_t componente6[2] = {2, 0};
+    const uint16_t sem_fixo[2] = {0, 0};
+    efeito_led_t fixa = {EFEITO_FIXO, {255, 0, 128}, {0, 0, 0}, 0};
+    efeitos_led_preenche_tabela(tabela, &fixa, gama, componente6, sem_fixo);
+    CONFERE_IGUAL(gama[128], metade(tabela[0], 0));
+    CONFERE_IGUAL(EFEITOS_NIVEL_MAX, metade(tabela[EFEITOS_PASSOS - 1], 1));
+
+    FIM_TESTES();
+}
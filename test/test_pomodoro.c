@@ -0,0 +1,120 @@
+// Máquina de estados do pomodoro (inc/pomodoro.c) contra um relógio virtual:
+// um dia inteiro em avanço automático, uma sessão manual de dois blocos até
+// CONCLUIDO, e acordadas atrasadas sem deriva.
+
+#include "teste.h"
+#include "pomodoro.h"
+
+#define SEGUNDO_US  1000000ull
+#define MINUTO_US   (60 * SEGUNDO_US)
+#define DIA_US      (24 * 60 * MINUTO_US)
+
+static uint32_t estado_aleatorio = 2024;
+
+static uint32_t aleatorio(void) {
+    estado_aleatorio = estado_aleatorio * 1664525u + 1013904223u;
+    return estado_aleatorio >> 8;
+}
+
+// Instante (desde o início da sessão) em que começa o estudo número `n`
+// (0, 1, ...) num cronograma automático sem fim
+static uint64_t inicio_estudo_us(const cronograma_t *c, uint32_t n) {
+    uint64_t bloco_us = ((uint64_t)c->ciclos * c->estudo_min + (c->ciclos - 1) * c->pausa_min + c->pausa_longa_min) * MINUTO_US;
+    uint32_t no_bloco = n % c->ciclos;
+    return (n / c->ciclos) * bloco_us + no_bloco * (uint64_t)(c->estudo_min + c->pausa_min) * MINUTO_US;
+}
+
+int main(void) {
+    pomodoro_t p;
+    const uint64_t t0 = 5 * SEGUNDO_US;
+
+    // Contagem: arredonda para cima e a fase dura exatamente estudo_min
+    cronograma_t classico = {25, 5, 4, 20, 0, true};
+    pomodoro_inicia(&p, &classico, t0);
+    CONFERE_IGUAL(FASE_ESTUDO, p.fase);
+    CONFERE_IGUAL(1500, pomodoro_restante_s(&p, t0));
+    CONFERE_IGUAL(1500, pomodoro_restante_s(&p, t0 + 1));
+    CONFERE_IGUAL(1499, pomodoro_restante_s(&p, t0 + SEGUNDO_US));
+    CONFERE_IGUAL(1500, pomodoro_duracao_fase_s(&p));
+    CONFERE(!pomodoro_atualiza(&p, t0 + 25 * MINUTO_US - 1));
+    CONFERE(pomodoro_atualiza(&p, t0 + 25 * MINUTO_US));
+    CONFERE_IGUAL(FASE_PAUSA, p.fase);
+    CONFERE_IGUAL(t0 + 25 * MINUTO_US, p.inicio_us);
+
+    // 24 h em avanço automático, acordando a cada 1..90 s: cada estudo
+    // começa exatamente no instante do cronograma (blocos de 135 min)
+    pomodoro_inicia(&p, &classico, t0);
+    uint32_t estudos = 1, longas = 0;
+    bool sem_deriva = true;
+    for (uint64_t agora = t0; agora < t0 + DIA_US;) {
+        agora += (1 + aleatorio() % 90) * SEGUNDO_US;
+        if (agora > t0 + DIA_US) agora = t0 + DIA_US;
+        FasePomodoro antes = p.fase;
+        if (!pomodoro_atualiza(&p, agora) || p.fase == antes) continue;
+        if (p.fase == FASE_ESTUDO) {
+            sem_deriva &= p.inicio_us == t0 + inicio_estudo_us(&classico, estudos);
+            estudos++;
+        }
+        if (p.fase == FASE_PAUSA_LONGA) longas++;
+        sem_deriva &= p.inicio_us <= agora && p.fim_us > agora;
+    }
+    CONFERE(sem_deriva);
+    CONFERE_IGUAL(10 * 4 + 4, estudos);   // 10 blocos de 135 min + 90 min
+    CONFERE_IGUAL(10, longas);
+    CONFERE_IGUAL(0, pomodoro_duracao_sessao_s(&classico));   // sem fim
+
+    // Acordar com horas de atraso aplica todas as fases de uma vez, pelos
+    // fins anteriores e não pelo instante da acordada
+    pomodoro_inicia(&p, &classico, t0);
+    CONFERE(pomodoro_atualiza(&p, t0 + 3 * 60 * MINUTO_US + 7 * SEGUNDO_US));
+    // 180 min = bloco (135) + estudo + pausa + 15 dos 25 do segundo estudo
+    CONFERE_IGUAL(FASE_ESTUDO, p.fase);
+    CONFERE_IGUAL(1, p.ciclo);
+    CONFERE_IGUAL(1, p.bloco);
+    CONFERE_IGUAL(t0 + (135 + 30) * MINUTO_US, p.inicio_us);
+
+    // Sessão manual de 2 blocos de 4 x (25, 5) + 20: espera cada
+    // confirmação, termina em CONCLUIDO, e a contagem soma 16200 s
+    cronograma_t sessao = {25, 5, 4, 20, 2, false};
+    CONFERE_IGUAL(16200, pomodoro_duracao_sessao_s(&sessao));
+    pomodoro_inicia(&p, &sessao, t0);
+    uint64_t agora = t0, contado_us = 0;
+    uint32_t confirmacoes = 0, fases = 0;
+    while (p.fase != FASE_CONCLUIDO && fases < 100) {
+        if (pomodoro_aguardando(&p)) {
+            CONFERE(!pomodoro_atualiza(&p, agora + DIA_US));   // esperas não expiram
+            agora += (aleatorio() % 600) * SEGUNDO_US;
+            CONFERE(pomodoro_confirma(&p, agora));
+            confirmacoes++;
+        } else {
+            CONFERE(!pomodoro_confirma(&p, agora));
+            contado_us += p.fim_us - p.inicio_us;
+            agora = p.fim_us + (aleatorio() % 30) * SEGUNDO_US;
+            CONFERE(pomodoro_atualiza(&p, agora));
+        }
+        fases++;
+    }
+    CONFERE_IGUAL(FASE_CONCLUIDO, p.fase);
+    CONFERE_IGUAL(16200 * SEGUNDO_US, contado_us);
+    CONFERE_IGUAL(2 * 4 + 2 * 4 - 1, confirmacoes);   // antes de cada pausa e de cada estudo seguinte
+    CONFERE(!pomodoro_aguardando(&p));
+    CONFERE(!pomodoro_atualiza(&p, agora + DIA_US));
+
+    // Pausa longa anunciada no último ciclo do bloco
+    pomodoro_inicia(&p, &sessao, t0);
+    p.ciclo = 3;
+    CONFERE(pomodoro_pausa_longa_a_seguir(&p));
+    p.ciclo = 2;
+    CONFERE(!pomodoro_pausa_longa_a_seguir(&p));
+
+    // ciclos = 0 vale como 1: sem pausa curta, direto para a longa
+    cronograma_t um = {10, 5, 0, 15, 1, true};
+    pomodoro_inicia(&p, &um, 0);
+    CONFERE(pomodoro_atualiza(&p, 10 * MINUTO_US));
+    CONFERE_IGUAL(FASE_PAUSA_LONGA, p.fase);
+    CONFERE(pomodoro_atualiza(&p, 25 * MINUTO_US));
+    CONFERE_IGUAL(FASE_CONCLUIDO, p.fase);
+    CONFERE_IGUAL(25 * 60, pomodoro_duracao_sessao_s(&um));
+
+    FIM_TESTES();
+}
@@ -0,0 +1,234 @@
+// Parser do protocolo USB (inc/protocolo.c): quadros colados, quadros
+// truncados, timeout entre bytes e um fluxo aleatório de lixo intercalado
+// com quadros válidos, como chega pela CDC (rajadas com o mesmo instante).
+// A vazão do parser sobre esse fluxo é impressa (não é conferida).
+
+#include <string.h>
+#include <time.h>
+#include "teste.h"
+#include "protocolo.h"
+
+#define TIPO_TESTE  0x7E
+#define MAX_FLUXO   200000
+#define MAX_QUADROS 4000
+
+static protocolo_rx_t rx;
+static uint8_t fluxo[MAX_FLUXO];
+static uint32_t instante[MAX_FLUXO];   // ms de chegada de cada byte
+static size_t tamanho_fluxo;
+
+// Quadros entregues (tipo, tamanho e dados copiados)
+static struct { uint8_t tipo, tamanho, dados[PROTO_MAX_DADOS]; } entregues[MAX_QUADROS];
+static int num_entregues;
+
+static void entrega_todos(uint32_t agora_ms) {
+    protocolo_msg_t msg;
+    while (protocolo_proximo(&rx, agora_ms, &msg)) {
+        if (num_entregues == MAX_QUADROS) continue;
+        entregues[num_entregues].tipo = msg.tipo;
+        entregues[num_entregues].tamanho = msg.tamanho;
+        memcpy(entregues[num_entregues].dados, msg.dados, msg.tamanho);
+        num_entregues++;
+    }
+}
+
+static void recebe(const uint8_t *bytes, size_t n, uint32_t agora_ms) {
+    for (size_t i = 0; i < n; i++) {
+        protocolo_recebe(&rx, bytes[i], agora_ms);
+        entrega_todos(agora_ms);
+    }
+}
+
+static size_t quadro(uint8_t *saida, uint8_t tipo, uint8_t tamanho, uint8_t semente) {
+    uint8_t dados[PROTO_MAX_DADOS];
+    for (int i = 0; i < tamanho; i++) dados[i] = (uint8_t)(semente + i * 7);
+    return protocolo_monta(saida, tipo, dados, tamanho);
+}
+
+static bool confere_dados(int k, uint8_t tamanho, uint8_t semente) {
+    if (entregues[k].tipo != TIPO_TESTE || entregues[k].tamanho != tamanho) return false;
+    for (int i = 0; i < tamanho; i++) {
+        if (entregues[k].dados[i] != (uint8_t)(semente + i * 7)) return false;
+    }
+    return true;
+}
+
+static void reinicia(void) {
+    protocolo_rx_inicia(&rx);
+    num_entregues = 0;
+}
+
+// ---------------------- FLUXO ALEATÓRIO ---------------------------
+static uint32_t estado_aleatorio = 12345;
+
+static uint32_t aleatorio(void) {
+    estado_aleatorio = estado_aleatorio * 1664525u + 1013904223u;
+    return estado_aleatorio >> 8;
+}
+
+static void fuzz(bool pausas) {
+    static struct { uint8_t tamanho, semente; } enviados[MAX_QUADROS];
+    int num_enviados = 0;
+    uint32_t agora = 1000;
+    tamanho_fluxo = 0;
+
+    while (num_enviados < 1000) {
+        // Lixo: bytes quaisquer, às vezes com syncs e cabeçalhos plausíveis,
+        // às vezes um quadro válido cortado
+        size_t lixo = aleatorio() % 40;
+        for (size_t i = 0; i < lixo; i++) {
+            uint32_t a = aleatorio();
+            uint8_t b = (a % 5 == 0) ? PROTO_SYNC0 : (a % 5 == 1) ? PROTO_SYNC1 : (uint8_t)(a >> 8);
+            instante[tamanho_fluxo] = agora;
+            fluxo[tamanho_fluxo++] = b;
+        }
+        if (aleatorio() % 3 == 0) {
+            uint8_t cortado[PROTO_MAX_QUADRO];
+            size_t n = quadro(cortado, TIPO_TESTE, (uint8_t)(aleatorio() % (PROTO_MAX_DADOS + 1)), 0);
+            size_t corte = 1 + aleatorio() % (n - 1);
+            for (size_t i = 0; i < corte; i++) {
+                instante[tamanho_fluxo] = agora;
+                fluxo[tamanho_fluxo++] = cortado[i];
+            }
+        }
+        if (pausas && aleatorio() % 2) agora += PROTO_TIMEOUT_MS + 1 + aleatorio() % 100;
+
+        uint8_t tamanho = (uint8_t)(aleatorio() % (PROTO_MAX_DADOS + 1));
+        uint8_t semente = (uint8_t)aleatorio();
+        size_t n = quadro(&fluxo[tamanho_fluxo], TIPO_TESTE, tamanho, semente);
+        for (size_t i = 0; i < n; i++) instante[tamanho_fluxo + i] = agora;
+        tamanho_fluxo += n;
+        enviados[num_enviados].tamanho = tamanho;
+        enviados[num_enviados++].semente = semente;
+        agora += aleatorio() % 3;
+    }
+
+    reinicia();
+    for (size_t i = 0; i < tamanho_fluxo; i++) {
+        protocolo_recebe(&rx, fluxo[i], instante[i]);
+        entrega_todos(instante[i]);
+    }
+    entrega_todos(agora + PROTO_TIMEOUT_MS + 1);
+
+    // Todo quadro válido sai, na ordem e íntegro; o lixo não forja nenhum
+    int k = 0, certos = 0;
+    for (int e = 0; e < num_entregues && k < num_enviados; e++) {
+        if (confere_dados(e, enviados[k].tamanho, enviados[k].semente)) {
+            certos++;
+            k++;
+        }
+    }
+    CONFERE_IGUAL(num_enviados, certos);
+    CONFERE_IGUAL(num_enviados, num_entregues);
+    CONFERE_IGUAL(0, rx.usados);
+}
+
+// Reprocessa o último fluxo do fuzz várias vezes e imprime a vazão
+static void vazao(int rodadas) {
+    uint32_t fim = instante[tamanho_fluxo - 1] + PROTO_TIMEOUT_MS + 1;
+    long quadros = 0;
+    clock_t inicio = clock();
+    for (int r = 0; r < rodadas; r++) {
+        reinicia();
+        for (size_t i = 0; i < tamanho_fluxo; i++) {
+            protocolo_recebe(&rx, fluxo[i], instante[i]);
+            entrega_todos(instante[i]);
+        }
+        entrega_todos(fim);
+        quadros += num_entregues;
+    }
+    double s = (double)(clock() - inicio) / CLOCKS_PER_SEC;
+    if (s <= 0) s = 1e-9;
+    printf("vazão: %d x %zu bytes em %.3f s: %.1f MB/s, %.0f quadros/s\n", rodadas, tamanho_fluxo, s,
+           (double)rodadas * tamanho_fluxo / s / 1e6, quadros / s);
+    CONFERE_IGUAL(1000L * rodadas, quadros);
+}
+
+int main(void) {
+    uint8_t a[PROTO_MAX_QUADRO], b[PROTO_MAX_QUADRO], c[PROTO_MAX_QUADRO];
+    size_t na = quadro(a, TIPO_TESTE, 3, 10);
+    size_t nb = quadro(b, TIPO_TESTE, 0, 20);
+    size_t nc = quadro(c, TIPO_TESTE, PROTO_MAX_DADOS, 30);
+
+    // CRC-16/CCITT-FALSE de "123456789"
+    CONFERE_IGUAL(0x29B1, protocolo_crc16((const uint8_t *)"123456789", 9));
+
+    // Quadro simples
+    reinicia();
+    recebe(a, na, 0);
+    CONFERE_IGUAL(1, num_entregues);
+    CONFERE(confere_dados(0, 3, 10));
+
+    // Três quadros colados na mesma rajada: todos saem
+    reinicia();
+    recebe(a, na, 0);
+    recebe(b, nb, 0);
+    recebe(c, nc, 0);
+    CONFERE_IGUAL(3, num_entregues);
+    CONFERE(confere_dados(0, 3, 10) && confere_dados(1, 0, 20) && confere_dados(2, PROTO_MAX_DADOS, 30));
+
+    // Quadro truncado logo antes de dois válidos: o cabeçalho cortado
+    // engole os dois, o CRC dele falha e o reexame entrega os dois
+    reinicia();
+    recebe(c, 10, 0);
+    recebe(a, na, 0);
+    recebe(b, nb, 0);
+    CONFERE_IGUAL(0, num_entregues);   // ainda dentro do quadro truncado
+    entrega_todos(PROTO_TIMEOUT_MS);
+    CONFERE_IGUAL(0, num_entregues);
+    entrega_todos(PROTO_TIMEOUT_MS + 1);
+    CONFERE_IGUAL(2, num_entregues);
+    CONFERE(confere_dados(0, 3, 10) && confere_dados(1, 0, 20));
+    CONFERE_IGUAL(0, rx.usados);
+
+    // Com cabeçalho curto o truncado completa antes, e os dois saem sem timeout
+    uint8_t curto[PROTO_MAX_QUADRO];
+    quadro(curto, TIPO_TESTE, 4, 0);
+    reinicia();
+    recebe(curto, 5, 0);
+    recebe(a, na, 0);
+    recebe(b, nb, 0);
+    CONFERE_IGUAL(2, num_entregues);
+    CONFERE(confere_dados(0, 3, 10) && confere_dados(1, 0, 20));
+    CONFERE(rx.erros_crc >= 1);
+
+    // Pausa maior que o timeout: o parcial antigo é abandonado quando chega
+    // o próximo byte, e o quadro novo sai inteiro
+    reinicia();
+    recebe(c, 50, 0);
+    recebe(a, na, PROTO_TIMEOUT_MS + 1);
+    CONFERE_IGUAL(1, num_entregues);
+    CONFERE(confere_dados(0, 3, 10));
+    CONFERE(rx.expirados >= 1);
+
+    // Pausa menor que o timeout no meio do quadro não o perde
+    reinicia();
+    recebe(c, 50, 0);
+    recebe(c + 50, nc - 50, PROTO_TIMEOUT_MS);
+    CONFERE_IGUAL(1, num_entregues);
+    CONFERE(confere_dados(0, PROTO_MAX_DADOS, 30));
+
+    // Parcial parado e nenhum byte novo: a consulta periódica limpa o buffer
+    reinicia();
+    recebe(a, na - 1, 0);
+    entrega_todos(PROTO_TIMEOUT_MS + 1);
+    CONFERE_IGUAL(0, num_entregues);
+    CONFERE_IGUAL(0, rx.usados);
+
+    // CRC errado não entrega nada e o próximo quadro sai
+    reinicia();
+    uint8_t ruim[PROTO_MAX_QUADRO];
+    memcpy(ruim, a, na);
+    ruim[5] ^= 0x01;
+    recebe(ruim, na, 0);
+    recebe(b, nb, 0);
+    CONFERE_IGUAL(1, num_entregues);
+    CONFERE(confere_dados(0, 0, 20));
+
+    // Fluxo aleatório, sem e com pausas longas
+    fuzz(false);
+    fuzz(true);
+    vazao(200);
+
+    FIM_TESTES();
+}
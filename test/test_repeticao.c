@@ -0,0 +1,106 @@
+// Curva de auto-repetição do editor de horário (inc/repeticao.c com a
+// configuração de inc/horario.c) e os modos campo/dígito do cursor, com o
+// joystick amostrado a cada 20 ms como em editar_horario.
+
+#include "teste.h"
+#include "horario.h"
+
+#define AMOSTRA_MS 20
+
+static repeticao_t r;
+
+// Segura `deflexao` de `de_ms` até `ate_ms` (inclusive); retorna os passos
+static int segura(int deflexao, uint32_t de_ms, uint32_t ate_ms) {
+    int passos = 0;
+    for (uint32_t t = de_ms; t <= ate_ms; t += AMOSTRA_MS) passos += repeticao_atualiza(&r, &repeticao_edicao, deflexao, t);
+    return passos;
+}
+
+// Segura `deflexao` por `ms` num alvo do editor e aplica os passos
+static void segura_no_alvo(Horario *h, int alvo, int deflexao, uint32_t ms) {
+    repeticao_solta(&r);
+    for (uint32_t t = 0; t <= ms; t += AMOSTRA_MS) {
+        int passos = repeticao_atualiza(&r, &repeticao_edicao, deflexao, t);
+        if (passos != 0) ajusta_alvo(h, alvo, passos);
+    }
+}
+
+int main(void) {
+    // Intervalos da curva: 180 ms no começo, 35 ms depois de 350 + 1500 ms,
+    // e o dobro no limiar de deflexão
+    CONFERE_IGUAL(180, repeticao_intervalo(&repeticao_edicao, 100, 0));
+    CONFERE_IGUAL(180, repeticao_intervalo(&repeticao_edicao, 100, 350));
+    CONFERE_IGUAL(35, repeticao_intervalo(&repeticao_edicao, 100, 1850));
+    CONFERE_IGUAL(35, repeticao_intervalo(&repeticao_edicao, 100, 60000));
+    CONFERE_IGUAL(360, repeticao_intervalo(&repeticao_edicao, 49, 0));
+    CONFERE_IGUAL(70, repeticao_intervalo(&repeticao_edicao, 49, 1850));
+
+    // Passo imediato e nada até o atraso inicial
+    repeticao_solta(&r);
+    CONFERE_IGUAL(1, segura(100, 0, 0));
+    CONFERE_IGUAL(0, segura(100, 20, 340));
+    CONFERE_IGUAL(1, segura(100, 360, 360));
+
+    // Passos acumulados segurando no fim do curso por 1, 2 e 3 s. Até 1 s:
+    // 0, 350 e intervalos de 180 ms encurtando; depois de ~1,9 s, 35 ms, ou
+    // seja ~28 passos por segundo
+    repeticao_solta(&r);
+    int em_1s = segura(100, 0, 1000);
+    int em_2s = em_1s + segura(100, 1020, 2000);
+    int em_3s = em_2s + segura(100, 2020, 3000);
+    CONFERE_IGUAL(6, em_1s);
+    CONFERE_IGUAL(22, em_2s);
+    CONFERE_IGUAL(50, em_3s);
+    CONFERE(em_3s - em_2s >= 1000 / 35 - 1);
+
+    // Meia inclinação para a esquerda: mesmo sentido de contagem, mais lento
+    repeticao_solta(&r);
+    int meia_3s = segura(-75, 0, 3000);
+    CONFERE(meia_3s < 0);
+    CONFERE(-meia_3s < em_3s);
+    CONFERE(-meia_3s > em_2s);
+
+    // Abaixo do limiar é solto; soltar e inclinar de novo dá passo imediato
+    CONFERE_IGUAL(0, segura(30, 3020, 3020));
+    CONFERE_IGUAL(0, r.sentido);
+    CONFERE_IGUAL(1, segura(100, 3040, 3040));
+    // Inverter sem soltar também
+    CONFERE_IGUAL(-1, segura(-100, 3060, 3060));
+
+    // Rajada limitada depois de uma pausa longa entre amostras
+    repeticao_solta(&r);
+    segura(100, 0, 2000);
+    CONFERE_IGUAL(repeticao_edicao.max_passos, segura(100, 2500, 2500));
+
+    // Cursor: abaixo de HH sai no último dígito, acima de MM entra nos dígitos
+    CONFERE_IGUAL(ALVO_DIGITO + 3, move_alvo(ALVO_HORAS, -1));
+    CONFERE_IGUAL(ALVO_MINUTOS, move_alvo(ALVO_HORAS, 1));
+    CONFERE_IGUAL(ALVO_DIGITO, move_alvo(ALVO_MINUTOS, 1));
+    CONFERE_IGUAL(ALVO_HORAS, move_alvo(ALVO_DIGITO + 3, 1));
+
+    // Modo dígito: 50 passos na unidade da hora ficam em 0..9
+    Horario h = {0, 0};
+    segura_no_alvo(&h, ALVO_DIGITO + 1, 100, 3000);
+    CONFERE_IGUAL(0, h.horas);
+    CONFERE_IGUAL(0, h.minutos);
+    segura_no_alvo(&h, ALVO_DIGITO + 1, 100, 1000);
+    CONFERE_IGUAL(6, h.horas);
+
+    // Mudando para o modo campo, os mesmos 3 s andam a hora inteira com volta
+    h = (Horario){0, 0};
+    segura_no_alvo(&h, move_alvo(ALVO_DIGITO + 3, 1), 100, 3000);
+    CONFERE_IGUAL(50 % 24, h.horas);
+    segura_no_alvo(&h, ALVO_MINUTOS, 100, 3000);
+    CONFERE_IGUAL(50, h.minutos);
+    segura_no_alvo(&h, ALVO_MINUTOS, -100, 3000);
+    CONFERE_IGUAL(0, h.minutos);
+
+    // 23:59 a partir de 00:00: um toque para a esquerda em cada campo
+    h = (Horario){0, 0};
+    segura_no_alvo(&h, ALVO_HORAS, -100, 0);
+    segura_no_alvo(&h, ALVO_MINUTOS, -100, 0);
+    CONFERE_IGUAL(23, h.horas);
+    CONFERE_IGUAL(59, h.minutos);
+
+    FIM_TESTES();
+}
@@ -0,0 +1,210 @@
+// Template SSD1306 (inc/ssd1306.hpp via inc/ssd1306_shim.cpp) contra o driver
+// C anterior, reproduzido aqui como referência: mesmos bytes no barramento
+// (também em 128x32, 72x40 e em cada rotação), mesmo framebuffer, e a comparação de memória e de tempo por pixel que
+// motivou a troca (os números são impressos; só a equivalência é conferida).
+
+#include <chrono>
+#include <cstdarg>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "teste.h"
+#include "ssd1306.hpp"
+
+// ---------------------- STUBS DO SDK ---------------------------
+static std::vector<std::vector<uint8_t>> transacoes;
+
+extern "C" {
+uint i2c_init(i2c_inst_t *, uint baudrate) { return baudrate; }
+int i2c_write_blocking(i2c_inst_t *, uint8_t, const uint8_t *src, size_t len, bool) {
+  transacoes.emplace_back(src, src + len);
+  return (int)len;
+}
+void gpio_set_function(uint, enum gpio_function) {}
+void gpio_pull_up(uint) {}
+void panic(const char *fmt, ...) {
+  va_list args;
+  va_start(args, fmt);
+  vfprintf(stderr, fmt, args);
+  va_end(args);
+  exit(2);
+}
+}
+
+// ---------------------- REFERÊNCIA: DRIVER C ANTERIOR ---------------------------
+static const uint8_t referencia_config[] = {
+  SET_DISP | 0x00,
+  SET_MEM_ADDR, 0x01,
+  SET_DISP_START_LINE | 0x00,
+  SET_SEG_REMAP | 0x01,
+  SET_MUX_RATIO, HEIGHT - 1,
+  SET_COM_OUT_DIR | 0x08,
+  SET_DISP_OFFSET, 0x00,
+  SET_COM_PIN_CFG, 0x12,
+  SET_DISP_CLK_DIV, 0x80,
+  SET_PRECHARGE, 0xF1,
+  SET_VCOM_DESEL, 0x30,
+  SET_CONTRAST, 0xFF,
+  SET_ENTIRE_ON,
+  SET_NORM_INV,
+  SET_CHARGE_PUMP, 0x14,
+  SET_DISP | 0x01
+};
+
+static const uint8_t referencia_janela[] = {
+  SET_COL_ADDR, 0, WIDTH - 1,
+  SET_PAGE_ADDR, 0, HEIGHT / 8 - 1
+};
+
+// Geometria lida da struct em tempo de execução, buffer no heap
+__attribute__((noinline)) static void referencia_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value) {
+  if (x < ssd->clip_x0 || x >= ssd->clip_x1 || y < ssd->clip_y0 || y >= ssd->clip_y1)
+    return;
+  uint16_t index = (y >> 3) + x * ssd->pages + 1;
+  uint8_t pixel = (y & 0b111);
+  if (value)
+    ssd->ram_buffer[index] |= (1 << pixel);
+  else
+    ssd->ram_buffer[index] &= ~(1 << pixel);
+}
+
+// ---------------------- COMPARAÇÃO ---------------------------
+// Bytes de comando de uma sequência de transações, sem os bytes de controle
+static std::vector<uint8_t> comandos(size_t de, size_t ate) {
+  std::vector<uint8_t> bytes;
+  for (size_t t = de; t < ate; t++) {
+    if (transacoes[t][0] != 0x00) continue;
+    bytes.insert(bytes.end(), transacoes[t].begin() + 1, transacoes[t].end());
+  }
+  return bytes;
+}
+
+// ---------------------- OUTRAS GEOMETRIAS E ROTAÇÕES ---------------------------
+// Transporte que só grava as transações, para instanciar o template direto
+struct Gravador {
+  std::vector<std::vector<uint8_t>> *saida = nullptr;
+  void write(const uint8_t *data, size_t length) const { saida->emplace_back(data, data + length); }
+};
+
+// Transações de config() seguida de send(): configuração, janela, dados
+template <uint8_t W, uint8_t H, ssd1306::Rotation R = ssd1306::Rotation::None>
+static std::vector<std::vector<uint8_t>> sequencias() {
+  std::vector<std::vector<uint8_t>> saida;
+  ssd1306::Ssd1306<W, H, Gravador, R> painel(Gravador{&saida});
+  painel.config();
+  painel.send();
+  return saida;
+}
+
+// Configuração do driver C anterior com os campos que dependem do painel
+static std::vector<uint8_t> config_esperada(uint8_t altura, uint8_t segmentos, uint8_t com, uint8_t pinos_com) {
+  std::vector<uint8_t> esperado{0x00};
+  esperado.insert(esperado.end(), referencia_config, referencia_config + sizeof(referencia_config) - 1);
+  for (size_t i = 1; i < esperado.size(); i++) {
+    if (esperado[i] == (SET_SEG_REMAP | 0x01)) esperado[i] = segmentos;
+    else if (esperado[i] == (SET_COM_OUT_DIR | 0x08)) esperado[i] = com;
+    else if (esperado[i] == SET_MUX_RATIO) esperado[++i] = altura - 1;
+    else if (esperado[i] == SET_COM_PIN_CFG) esperado[++i] = pinos_com;
+    else if (esperado[i] == SET_DISP_OFFSET || esperado[i] == SET_MEM_ADDR) i++;
+  }
+  return esperado;
+}
+
+static std::vector<uint8_t> janela_esperada(uint8_t coluna0, uint8_t coluna1, uint8_t paginas) {
+  return {0x00, SET_COL_ADDR, coluna0, coluna1, SET_PAGE_ADDR, 0, uint8_t(paginas - 1)};
+}
+
+static void confere_geometrias() {
+  using ssd1306::Rotation;
+  const uint8_t seg = SET_SEG_REMAP | 0x01, seg_inv = SET_SEG_REMAP | 0x00;
+  const uint8_t com = SET_COM_OUT_DIR | 0x08, com_inv = SET_COM_OUT_DIR | 0x00;
+
+  // 128x32: pinos COM sequenciais (0x02), 4 páginas
+  auto t = sequencias<128, 32>();
+  CONFERE(t[0] == config_esperada(32, seg, com, 0x02));
+  CONFERE(t[1] == janela_esperada(0, 127, 4));
+  CONFERE_IGUAL(128u * 4 + 1, t[2].size());
+
+  // 72x40: colunas centrais 28..99 da GDDRAM, 5 páginas
+  static_assert(ssd1306::Ssd1306<72, 40, Gravador>::column_offset == 28, "72x40 começa na coluna 28");
+  t = sequencias<72, 40>();
+  CONFERE(t[0] == config_esperada(40, seg, com, 0x12));
+  CONFERE(t[1] == janela_esperada(28, 99, 5));
+  CONFERE_IGUAL(72u * 5 + 1, t[2].size());
+
+  // Rotações: só o remapeamento de segmentos e a varredura COM mudam
+  auto nenhuma = sequencias<128, 64, Rotation::None>();
+  auto rot180 = sequencias<128, 64, Rotation::Rot180>();
+  auto espelho_x = sequencias<128, 64, Rotation::MirrorX>();
+  auto espelho_y = sequencias<128, 64, Rotation::MirrorY>();
+  CONFERE(nenhuma[0] == config_esperada(64, seg, com, 0x12));
+  CONFERE(rot180[0] == config_esperada(64, seg_inv, com_inv, 0x12));
+  CONFERE(espelho_x[0] == config_esperada(64, seg_inv, com, 0x12));
+  CONFERE(espelho_y[0] == config_esperada(64, seg, com_inv, 0x12));
+  CONFERE(rot180[1] == janela_esperada(0, 127, 8));
+}
+
+static uint8_t padrao(uint8_t x, uint8_t y, unsigned rodada) { return ((x * 7u) ^ (y * 3u) ^ rodada) & 1u; }
+
+template <typename Pixel>
+static double ns_por_pixel(ssd1306_t *ssd, Pixel pixel, unsigned rodadas) {
+  auto inicio = std::chrono::steady_clock::now();
+  for (unsigned r = 0; r < rodadas; r++)
+    for (uint8_t x = 0; x < WIDTH; x++)
+      for (uint8_t y = 0; y < HEIGHT; y++) pixel(ssd, x, y, padrao(x, y, r));
+  std::chrono::duration<double, std::nano> dt = std::chrono::steady_clock::now() - inicio;
+  return dt.count() / (double(rodadas) * WIDTH * HEIGHT);
+}
+
+int main() {
+  ssd1306_t display{};
+  ssd1306_init_config(&display, 15, 14, nullptr, 0x3C);
+  ssd1306_send_data(&display);
+  ssd1306_power(&display, true);
+
+  // Mesmos comandos que o driver anterior (que ligava o painel no fim da
+  // configuração; agora o power vem depois do primeiro quadro)
+  std::vector<uint8_t> esperado(referencia_config, referencia_config + sizeof(referencia_config) - 1);
+  CONFERE(comandos(0, 1) == esperado);
+  CONFERE(comandos(1, 2) == std::vector<uint8_t>(referencia_janela, referencia_janela + sizeof(referencia_janela)));
+  CONFERE_IGUAL(WIDTH * HEIGHT / 8 + 1, transacoes[2].size());
+  CONFERE_IGUAL(0x40, transacoes[2][0]);
+  CONFERE(comandos(3, 4) == std::vector<uint8_t>{SET_DISP | 0x01});
+
+  confere_geometrias();
+
+  // Mesmo framebuffer para o mesmo desenho
+  ssd1306_t referencia = display;
+  referencia.ram_buffer = static_cast<uint8_t *>(calloc(display.bufsize, 1));
+  referencia.ram_buffer[0] = 0x40;
+  for (uint8_t x = 0; x < WIDTH; x++)
+    for (uint8_t y = 0; y < HEIGHT; y++) {
+      ssd1306_pixel(&display, x, y, padrao(x, y, 1));
+      referencia_pixel(&referencia, x, y, padrao(x, y, 1));
+    }
+  CONFERE_IGUAL(0, memcmp(display.ram_buffer, referencia.ram_buffer, display.bufsize));
+
+  // Telas pré-compostas (tools/gera_telas.py): cópia de glifo igual a
+  // draw_string, inclusive fora do alinhamento de página e sobre fundo aceso
+  static const uint8_t tela[] = {10, 5, 6, 11, 38, 63, 2, 0, 62, 20, 40, 2, 63, 1, 0xFF};
+  ssd1306_fill(&display, true);
+  ssd1306_draw_string(&display, "Ab:1 z", 10, 5);
+  ssd1306_draw_string(&display, ":0", 20, 40);
+  memcpy(referencia.ram_buffer, display.ram_buffer, display.bufsize);
+  ssd1306_fill(&display, true);
+  ssd1306_draw_compressed(&display, tela);
+  CONFERE_IGUAL(0, memcmp(display.ram_buffer, referencia.ram_buffer, display.bufsize));
+
+  // Memória: buffer estático do tamanho exato contra struct + calloc
+  using Painel = ssd1306::Ssd1306<WIDTH, HEIGHT, ssd1306::I2cTransport>;
+  printf("memória: template %zu bytes estáticos; C %zu bytes de heap + cabeçalho do malloc\n",
+         sizeof(Painel), display.bufsize);
+
+  const unsigned rodadas = 2000;
+  double c = ns_por_pixel(&referencia, referencia_pixel, rodadas);
+  double t = ns_por_pixel(&display, ssd1306_pixel, rodadas);
+  printf("pixel: C %.2f ns, template %.2f ns (%.2fx)\n", c, t, c / t);
+
+  free(referencia.ram_buffer);
+  FIM_TESTES();
+}
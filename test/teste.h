@@ -0,0 +1,38 @@
+#ifndef TESTE_H
+#define TESTE_H
+
+// Verificações mínimas dos testes no host: cada CONFERE que falha é impresso
+// e o teste termina com código != 0 em FIM_TESTES().
+
+#include <stdio.h>
+
+static int testes_falhas = 0;
+static int testes_conferidos = 0;
+
+#define CONFERE(cond)                                                   \
+    do {                                                                \
+        testes_conferidos++;                                            \
+        if (!(cond)) {                                                  \
+            fprintf(stderr, "%s:%d: falhou: %s\n", __FILE__, __LINE__, #cond); \
+            testes_falhas++;                                            \
+        }                                                               \
+    } while (0)
+
+#define CONFERE_IGUAL(esperado, obtido)                                 \
+    do {                                                                \
+        long long e_ = (long long)(esperado), o_ = (long long)(obtido); \
+        testes_conferidos++;                                            \
+        if (e_ != o_) {                                                 \
+            fprintf(stderr, "%s:%d: %s: esperado %lld, obtido %lld\n",  \
+                    __FILE__, __LINE__, #obtido, e_, o_);               \
+            testes_falhas++;                                            \
+        }                                                               \
+    } while (0)
+
+#define FIM_TESTES()                                                    \
+    do {                                                                \
+        printf("%d verificações, %d falhas\n", testes_conferidos, testes_falhas); \
+        return testes_falhas ? 1 : 0;                                   \
+    } while (0)
+
+#endif
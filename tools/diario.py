@@ -0,0 +1,88 @@
+#!/usr/bin/env python3
+"""Leitor do diário de eventos da placa (inc/diario.h).
+
+  diario.py <porta> [--bruto]
+
+Pede à placa a tabela de formatos (PROTO_FORMATO), que só existe na flash
+dela, e depois imprime cada registro que chega em quadros PROTO_DIARIO:
+
+  tempo(s)  núcleo  texto
+
+Os argumentos entram no formato com str.format ({a}, {b}). Registros
+sobrescritos antes de chegar (anel cheio, USB desconectada) são avisados
+com a contagem. --bruto mostra id e argumentos sem consultar os formatos.
+O texto de printf que dividir a porta é ignorado.
+"""
+
+import struct
+import sys
+
+from protocolo import Leitor, transacao
+
+DIARIO, FORMATO = 0x05, 0x06
+
+# diario_registro_t: tempo_us, seq, evento, nucleo, a, b
+REGISTRO = struct.Struct("<IHBBII")
+
+
+def le_formatos(porta):
+    resp = transacao(porta, FORMATO, bytes([0]))
+    formatos = [None] * resp[0]
+    for evento in range(resp[0]):
+        if evento > 0:
+            resp = transacao(porta, FORMATO, bytes([evento]))
+        if len(resp) >= 2 and resp[1] == evento:
+            formatos[evento] = resp[2:].decode("utf-8", "replace")
+    return formatos
+
+
+def formata(formatos, evento, a, b):
+    if formatos is None or evento >= len(formatos) or formatos[evento] is None:
+        return "evento %d a=%d b=%d" % (evento, a, b)
+    try:
+        return formatos[evento].format(a=a, b=b)
+    except (ValueError, IndexError, KeyError):
+        return "%s [a=%d b=%d]" % (formatos[evento], a, b)
+
+
+class Relogio:
+    """Estende o time_us_32() da placa para além dos ~71 minutos."""
+
+    def __init__(self):
+        self.voltas = 0
+        self.ultimo = None
+
+    def segundos(self, tempo_us):
+        if self.ultimo is not None and tempo_us < self.ultimo and self.ultimo - tempo_us > 1 << 31:
+            self.voltas += 1
+        self.ultimo = tempo_us
+        return ((self.voltas << 32) + tempo_us) / 1e6
+
+
+def main():
+    args = [a for a in sys.argv[1:] if not a.startswith("--")]
+    if len(args) != 1:
+        sys.exit(__doc__)
+    import serial
+
+    with serial.Serial(args[0], 115200, timeout=0.1) as porta:
+        formatos = None if "--bruto" in sys.argv else le_formatos(porta)
+        leitor = Leitor()
+        relogio = Relogio()
+        perdidos = 0
+        while True:
+            for tipo, dados in leitor.alimenta(porta.read(porta.in_waiting or 1)):
+                if tipo != DIARIO or len(dados) < 4:
+                    continue
+                total, = struct.unpack_from("<I", dados)
+                if total != perdidos:
+                    print("-- %d registros perdidos" % (total - perdidos))
+                    perdidos = total
+                for tempo_us, _, evento, nucleo, a, b in REGISTRO.iter_unpack(dados[4:]):
+                    print("%12.6f  n%d  %s" % (relogio.segundos(tempo_us), nucleo,
+                                               formata(formatos, evento, a, b)))
+                sys.stdout.flush()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,174 @@
+#!/usr/bin/env python3
+"""Gera os textos fixos das telas estáticas, pré-compostos para a flash.
+
+Renderiza no host, com a mesma fonte e as mesmas regras de
+ssd1306_draw_string, os textos fixos das telas e grava um header com cada
+tela codificada para ssd1306_draw_compressed.
+
+Uso: gera_telas.py <font.h> <saida.h>
+
+Só as linhas de texto são guardadas (moldura e fundo vazio continuam sendo
+desenhados em runtime, byte a byte). A codificação é por dicionário: cada
+célula 8x8 de uma linha é substituída pelo índice do glifo igual na própria
+fonte, que já está na flash para o texto dinâmico. Formato:
+  linha: x, y, n, n índices de glifo (as quebras de ssd1306_draw_string já
+         aplicadas, então cada linha é contínua);
+  0xFF no lugar de x encerra a tela.
+O script decodifica cada tela com um modelo do decodificador (cópia de
+célula) e confere pixel a pixel contra a renderização de draw_string.
+"""
+
+import re
+import sys
+
+LARGURA = 128
+ALTURA = 64
+PAGINAS = ALTURA // 8
+FIM = 0xFF
+
+# Cada tela: (nome, [(texto, x, y), ...]).
+# Mantenha em sincronia com as funções de desenho de ProjetoFinal_Embarca.c.
+TELAS = [
+    ("tela_boas_vindas", [
+        ("Bem vindo ao", 10, 5),
+        ("Study Buddy", 10, 20),
+        ("clique A para", 10, 40),
+        ("continuar", 10, 50),
+    ]),
+    ("tela_menu_principal", [
+        ("Alarme", 22, 10),
+        ("de estudos", 22, 20),
+        ("Metodo", 22, 40),
+        ("pomodoro", 20, 50),
+    ]),
+    # As opções vêm dos presets em uso (a USB pode trocá-las)
+    ("tela_menu_pomodoro", [
+        ("Metodo pomodoro", 6, 5),
+    ]),
+]
+
+# Custo em flash (Thumb) de cada chamada ssd1306_draw_string substituída:
+# quatro instruções de argumentos, bl e a palavra com o endereço da string
+BYTES_POR_CHAMADA = 16
+
+
+def le_fonte(caminho):
+    with open(caminho, encoding="utf-8") as f:
+        texto = f.read()
+    corpo = texto[texto.index("{") + 1:texto.index("}")]
+    corpo = re.sub(r"//[^\n]*", "", corpo)
+    return [int(v, 16) for v in re.findall(r"0x[0-9a-fA-F]+", corpo)]
+
+
+def glifo(c):
+    """Índice do glifo de `c` na fonte (mesmo mapeamento de ssd1306_draw_char)."""
+    if "A" <= c <= "Z":
+        return ord(c) - ord("A") + 11
+    if "0" <= c <= "9":
+        return ord(c) - ord("0") + 1
+    if "a" <= c <= "z":
+        return ord(c) - ord("a") + 37
+    if c == ":":
+        return 63
+    return 0
+
+
+class Tela:
+    def __init__(self, fonte):
+        self.fonte = fonte
+        self.buffer = bytearray(LARGURA * PAGINAS)
+
+    def pixel(self, x, y, valor):
+        if not (0 <= x < LARGURA and 0 <= y < ALTURA):
+            return
+        indice = x * PAGINAS + (y >> 3)
+        if valor:
+            self.buffer[indice] |= 1 << (y & 7)
+        else:
+            self.buffer[indice] &= ~(1 << (y & 7)) & 0xFF
+
+    def celula(self, g, x, y):
+        for i in range(8):
+            coluna = self.fonte[g * 8 + i]
+            for j in range(8):
+                self.pixel(x + i, y + j, coluna & (1 << j))
+
+    def texto(self, s, x, y):
+        """ssd1306_draw_string pixel a pixel; devolve as linhas contínuas."""
+        linhas = [(x, y, [])]
+        for c in s:
+            self.celula(glifo(c), x, y)
+            linhas[-1][2].append(glifo(c))
+            x = (x + 8) & 0xFF
+            if x + 8 >= LARGURA:
+                x = 0
+                y = (y + 8) & 0xFF
+                linhas.append((x, y, []))
+            if y + 8 >= ALTURA:
+                break
+        return [linha for linha in linhas if linha[2]]
+
+
+def codifica(linhas):
+    saida = bytearray()
+    for x, y, glifos in linhas:
+        assert x < FIM and y < ALTURA and len(glifos) < 256
+        saida += bytes([x, y, len(glifos)]) + bytes(glifos)
+    saida.append(FIM)
+    return bytes(saida)
+
+
+def decodifica(fonte, dados):
+    """Modelo de ssd1306_draw_compressed sobre um buffer vazio."""
+    tela = Tela(fonte)
+    i = 0
+    while dados[i] != FIM:
+        x, y, n = dados[i:i + 3]
+        for g in dados[i + 3:i + 3 + n]:
+            tela.celula(g, x, y)
+            x += 8
+        i += 3 + n
+    return bytes(tela.buffer)
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit(__doc__)
+    fonte = le_fonte(sys.argv[1])
+
+    linhas = [
+        "// Arquivo gerado por tools/gera_telas.py. Não edite.",
+        "// Textos fixos das telas para ssd1306_draw_compressed.",
+        "",
+        "#include <stdint.h>",
+        "",
+    ]
+    total = substituido = 0
+    for nome, textos in TELAS:
+        tela = Tela(fonte)
+        linhas_texto = []
+        for s, x, y in textos:
+            linhas_texto += tela.texto(s, x, y)
+        dados = codifica(linhas_texto)
+        assert decodifica(fonte, dados) == bytes(tela.buffer), nome
+        total += len(dados)
+        # Strings alinhadas em 4 bytes, como o compilador as coloca
+        substituido += sum(BYTES_POR_CHAMADA + (len(s) + 4) // 4 * 4 for s, _, _ in textos)
+
+        linhas.append("// %d bytes (%d da página inteira)" % (len(dados), len(tela.buffer)))
+        for s, x, y in textos:
+            linhas.append("//   \"%s\" em (%d, %d)" % (s, x, y))
+        linhas.append("static const uint8_t %s[] = {" % nome)
+        for i in range(0, len(dados), 12):
+            linhas.append("    " + ", ".join("0x%02x" % b for b in dados[i:i + 12]) + ",")
+        linhas.append("};")
+        linhas.append("")
+
+    with open(sys.argv[2], "w", encoding="utf-8", newline="\n") as f:
+        f.write("\n".join(linhas))
+    print("gera_telas: %d telas, %d bytes (as chamadas substituídas ocupavam ~%d)"
+          % (len(TELAS), total, substituido))
+
+
+if __name__ == "__main__":
+    main()
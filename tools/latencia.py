@@ -0,0 +1,122 @@
+#!/usr/bin/env python3
+"""Analisa registros de latência do firmware e gera traces para replay.
+
+Os registros chegam pela stdio (USB/UART) em linhas
+    LAT,<tempo_us>,<tipo>,<tela>,<detalhe>,<a>,<b>
+quando o firmware é compilado com -DLATENCIA_HABILITADA=ON. Salve a saída
+serial em um arquivo (linhas de outros formatos são ignoradas) e use:
+
+  latencia.py analisa <log> [<log> ...]
+      Distribuição de latência entrada -> quadro enviado, por tela. Cada
+      marca de atendimento (a aplicação agiu sobre uma entrada) é atribuída
+      à entrada mais recente ainda não atendida, e o quadro seguinte fecha a
+      medida. Quadros sem atendimento antes deles (contagens por tempo) e
+      entradas ignoradas pela tela não entram na conta.
+
+  latencia.py trace <log> <saida.h>
+      Extrai as entradas (joystick e botões) em um header para replay:
+      cmake -DLATENCIA_TRACE=<saida.h> ...
+"""
+
+import sys
+
+LAT_JOYSTICK, LAT_BOTAO, LAT_QUADRO, LAT_ATENDE = 0, 1, 2, 3
+JOY_NENHUM = 0
+
+TELAS = [
+    "boas vindas",
+    "menu principal",
+    "editar hora atual",
+    "editar alarme",
+    "menu pomodoro",
+    "contagem alarme",
+    "pomodoro",
+]
+
+
+def le_registros(caminhos):
+    registros = []
+    for caminho in caminhos:
+        with open(caminho, encoding="utf-8", errors="replace") as f:
+            for linha in f:
+                campos = linha.strip().split(",")
+                if len(campos) != 7 or campos[0] != "LAT":
+                    continue
+                try:
+                    registros.append(tuple(int(c) for c in campos[1:]))
+                except ValueError:
+                    continue
+    registros.sort(key=lambda r: r[0])
+    return registros
+
+
+def eh_entrada(registro, direcao_anterior):
+    # O joystick também é registrado a cada variação de deflexão (para o
+    # replay); só a mudança para uma direção conta como nova entrada.
+    _, tipo, _, detalhe, _, _ = registro
+    return tipo == LAT_BOTAO or (tipo == LAT_JOYSTICK and detalhe != JOY_NENHUM
+                                 and detalhe != direcao_anterior)
+
+
+def percentil(valores, p):
+    k = (len(valores) - 1) * p / 100.0
+    i = int(k)
+    j = min(i + 1, len(valores) - 1)
+    return valores[i] + (valores[j] - valores[i]) * (k - i)
+
+
+def analisa(caminhos):
+    por_tela = {}
+    ultima_entrada = None   # entrada ainda não atendida
+    causa = None            # entrada atendida esperando o quadro
+    direcao = JOY_NENHUM    # direção do último registro do joystick
+    for registro in le_registros(caminhos):
+        tempo, tipo, tela = registro[0], registro[1], registro[2]
+        if eh_entrada(registro, direcao):
+            ultima_entrada = (tempo, tela)
+        if tipo == LAT_JOYSTICK:
+            direcao = registro[3]
+        elif tipo == LAT_ATENDE:
+            if causa is None and ultima_entrada is not None:
+                causa = ultima_entrada
+            ultima_entrada = None
+        elif tipo == LAT_QUADRO and causa is not None:
+            por_tela.setdefault(causa[1], []).append(tempo - causa[0])
+            causa = None
+
+    if not por_tela:
+        print("nenhuma entrada seguida de quadro encontrada")
+        return
+    print("%-20s %6s %9s %9s %9s %9s %9s" % ("tela", "n", "min ms", "p50 ms", "p90 ms", "p99 ms", "max ms"))
+    for tela in sorted(por_tela):
+        valores = sorted(v / 1000.0 for v in por_tela[tela])
+        nome = TELAS[tela] if tela < len(TELAS) else str(tela)
+        print("%-20s %6d %9.1f %9.1f %9.1f %9.1f %9.1f" % (
+            nome, len(valores), valores[0], percentil(valores, 50),
+            percentil(valores, 90), percentil(valores, 99), valores[-1]))
+
+
+def trace(caminho, saida):
+    entradas = [r for r in le_registros([caminho]) if r[1] in (LAT_JOYSTICK, LAT_BOTAO)]
+    with open(saida, "w", encoding="utf-8", newline="\n") as f:
+        f.write("// Gerado por tools/latencia.py a partir de %s. Não edite.\n" % caminho)
+        f.write("static const lat_registro_t trace_replay[] = {\n")
+        for tempo, tipo, tela, detalhe, a, b in entradas:
+            f.write("    {%d, %d, %d, %d, %d, %d},\n" % (tempo, tipo, tela, detalhe, a, b))
+        if not entradas:
+            f.write("    {0xFFFFFFFF, %d, 0, 0, 2048, 2048},\n" % LAT_JOYSTICK)
+        f.write("};\n")
+    print("trace: %d entradas" % len(entradas))
+
+
+def main():
+    if len(sys.argv) >= 3 and sys.argv[1] == "analisa":
+        analisa(sys.argv[2:])
+    elif len(sys.argv) == 4 and sys.argv[1] == "trace":
+        trace(sys.argv[2], sys.argv[3])
+    else:
+        sys.exit(__doc__)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,177 @@
+#!/usr/bin/env python3
+"""Cliente do protocolo binário de configuração (inc/protocolo.h).
+
+Fala com uma ou mais placas pela USB CDC (pyserial). Várias portas podem ser
+passadas separadas por vírgula para configurar uma turma de uma vez:
+
+  protocolo.py <porta>[,<porta>...] relogio [HH:MM[:SS]]
+      Acerta o relógio (sem horário: hora local do computador).
+
+  protocolo.py <porta>[,<porta>...] alarmes [HH:MM ...]
+      Substitui a lista de alarmes (até 8; sem horários: limpa a lista).
+
+  protocolo.py <porta>[,<porta>...] presets [PRESET ...]
+      Troca os presets do pomodoro (até 4; sem valores: volta ao padrão).
+      PRESET = ESTUDO/PAUSA[/CICLOS[/PAUSA_LONGA[/BLOCOS]]][+auto], em
+      minutos; ex.: 25/5/4/20 (4 ciclos e pausa longa de 20), 50/10/2/0/3+auto
+      (3 blocos de 2 ciclos, sem pausa longa, avançando sozinho).
+
+  protocolo.py <porta>[,<porta>...] estado
+      Mostra estado, relógio, contagem do alarme e do pomodoro.
+"""
+
+import struct
+import sys
+import time
+
+SYNC = b"\xa5\x5a"
+MAX_DADOS = 120
+
+RELOGIO, ALARMES, PRESETS, CONSULTA = 0x01, 0x02, 0x03, 0x04
+RESPOSTA = 0x80
+STATUS = {0: "ok", 1: "inválido", 2: "desconhecido"}
+
+ESTADOS = [
+    "boas vindas", "menu principal", "editar hora atual", "editar alarme",
+    "menu pomodoro", "contagem alarme", "pomodoro",
+]
+FASES = ["estudo", "aguarda pausa", "pausa", "aguarda estudo", "pausa longa", "concluído"]
+
+# protocolo_estado_t
+ESTADO = struct.Struct("<BBBBBBIBBBIBB")
+
+PRESET_AUTOMATICO = 0x01
+
+
+def crc16(dados):
+    crc = 0xFFFF
+    for b in dados:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) & 0xFFFF if crc & 0x8000 else (crc << 1) & 0xFFFF
+    return crc
+
+
+def monta(tipo, dados=b""):
+    if len(dados) > MAX_DADOS:
+        raise ValueError("mensagem maior que %d bytes" % MAX_DADOS)
+    corpo = bytes([len(dados), tipo]) + dados
+    return SYNC + corpo + struct.pack("<H", crc16(corpo))
+
+
+class Leitor:
+    """Separa quadros de um fluxo de bytes, ignorando o que não é quadro."""
+
+    def __init__(self):
+        self.buffer = bytearray()
+
+    def alimenta(self, dados):
+        self.buffer += dados
+        quadros = []
+        while True:
+            inicio = self.buffer.find(SYNC)
+            if inicio < 0:
+                del self.buffer[:-1]
+                return quadros
+            del self.buffer[:inicio]
+            if len(self.buffer) < 4:
+                return quadros
+            tamanho = self.buffer[2]
+            if tamanho > MAX_DADOS:
+                del self.buffer[:1]
+                continue
+            total = 4 + tamanho + 2
+            if len(self.buffer) < total:
+                return quadros
+            crc, = struct.unpack_from("<H", self.buffer, total - 2)
+            if crc != crc16(self.buffer[2:total - 2]):
+                del self.buffer[:1]
+                continue
+            quadros.append((self.buffer[3], bytes(self.buffer[4:total - 2])))
+            del self.buffer[:total]
+
+
+def transacao(porta, tipo, dados=b"", espera=1.0):
+    porta.write(monta(tipo, dados))
+    leitor = Leitor()
+    limite = time.monotonic() + espera
+    while time.monotonic() < limite:
+        for resp_tipo, resp in leitor.alimenta(porta.read(porta.in_waiting or 1)):
+            if resp_tipo == tipo | RESPOSTA:
+                return resp
+    raise TimeoutError("sem resposta ao comando 0x%02x" % tipo)
+
+
+def le_horario(texto):
+    partes = [int(p) for p in texto.split(":")]
+    if len(partes) == 2:
+        partes.append(0)
+    h, m, s = partes
+    if not (0 <= h < 24 and 0 <= m < 60 and 0 <= s < 60):
+        raise ValueError("horário inválido: " + texto)
+    return h, m, s
+
+
+def le_preset(texto):
+    automatico = texto.endswith("+auto")
+    if automatico:
+        texto = texto[:-len("+auto")]
+    campos = [int(x) for x in texto.split("/")]
+    if not 2 <= len(campos) <= 5:
+        raise ValueError("preset inválido: " + texto)
+    estudo, pausa, ciclos, longa, blocos = campos + [4, 0, 0][len(campos) - 2:]
+    return [estudo, pausa, ciclos, longa, blocos, PRESET_AUTOMATICO if automatico else 0]
+
+
+def comando(args):
+    nome, valores = args[0], args[1:]
+    if nome == "relogio":
+        if valores:
+            h, m, s = le_horario(valores[0])
+        else:
+            agora = time.localtime()
+            h, m, s = agora.tm_hour, agora.tm_min, agora.tm_sec
+        return RELOGIO, bytes([h, m, s])
+    if nome == "alarmes":
+        horarios = [le_horario(v)[:2] for v in valores]
+        return ALARMES, bytes([len(horarios)] + [b for hm in horarios for b in hm])
+    if nome == "presets":
+        presets = [le_preset(v) for v in valores]
+        return PRESETS, bytes([len(presets)] + [b for preset in presets for b in preset])
+    if nome == "estado":
+        return CONSULTA, b""
+    sys.exit(__doc__)
+
+
+def mostra_estado(dados):
+    (estado, h, m, s, armado, num_alarmes, alarme_s, ativo, fase, ciclo, fase_s,
+     num_presets, preset) = ESTADO.unpack(dados)
+    print("  estado:   %s" % (ESTADOS[estado] if estado < len(ESTADOS) else estado))
+    print("  relógio:  %02d:%02d:%02d" % (h, m, s))
+    alarme = "em %ds" % alarme_s if armado else "desarmado"
+    print("  alarmes:  %d na lista, próximo %s" % (num_alarmes, alarme))
+    if ativo:
+        print("  pomodoro: %s (ciclo %d), %ds restantes" % (FASES[fase], ciclo + 1, fase_s))
+    else:
+        print("  pomodoro: parado")
+    print("  presets:  %d (selecionado %d)" % (num_presets, preset))
+
+
+def main():
+    if len(sys.argv) < 3:
+        sys.exit(__doc__)
+    import serial
+
+    tipo, dados = comando(sys.argv[2:])
+    for nome in sys.argv[1].split(","):
+        with serial.Serial(nome, 115200, timeout=0.1) as porta:
+            resp = transacao(porta, tipo, dados)
+        print(nome)
+        if tipo == CONSULTA:
+            mostra_estado(resp)
+        else:
+            print("  %s" % STATUS.get(resp[0], resp[0]))
+
+
+if __name__ == "__main__":
+    main()